@@ -0,0 +1,24 @@
+# Display fonts, generated from the 64 px Montserrat font with only the characters set by the display functions.
+# Shared by the firmware and the host display test, the font_converter.py arguments are relative to the firmware
+# directory.
+set(FONT_SOURCE ${CMAKE_CURRENT_LIST_DIR}/../fonts/lv_font_montserrat_64.c)
+set(FONT_ARGS
+    # Tags
+    --font display_font_16:16
+    --chars-from display_font_16=src/components/e_paper_display.c:set_tags
+    # Notifications and air quality
+    --font display_font_24:24
+    --chars-from display_font_24=src/air_quality_monitor.c:run_pairing_window
+    --chars-from display_font_24=src/utils/air_quality_mapper.c:air_quality_from_voc_index
+    # Values, the digits, sign and decimal point are written by format_decimal
+    --font display_font_32:32
+    --chars display_font_32=0123456789-.
+    --chars-from display_font_32=src/components/e_paper_display.c:render_values
+)
+set(FONT_DEPENDS
+    ${CMAKE_CURRENT_LIST_DIR}/../scripts/font_converter.py
+    ${FONT_SOURCE}
+    ${CMAKE_CURRENT_LIST_DIR}/../src/components/e_paper_display.c
+    ${CMAKE_CURRENT_LIST_DIR}/../src/air_quality_monitor.c
+    ${CMAKE_CURRENT_LIST_DIR}/../src/utils/air_quality_mapper.c
+)
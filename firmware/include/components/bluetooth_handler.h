@@ -95,4 +95,18 @@ void update_advertisement_data(void);
  */
 int start_advertise(void);
 
+/**
+ * @brief Disable the BLE controller to save power while idle. Not possible while connected or pairing.
+ *
+ * @return int Zero for success, non-zero otherwise.
+ */
+int suspend_ble(void);
+
+/**
+ * @brief Enable the BLE controller again after suspend_ble. Does nothing if it was not suspended.
+ *
+ * @return int Zero for success, non-zero otherwise.
+ */
+int resume_ble(void);
+
 #endif // BLUETOOTH_HANDLER_H
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef DISPLAY_POLICY_H
+#define DISPLAY_POLICY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Content shown with the values
+ *
+ */
+typedef enum
+{
+    DISPLAY_FACE_DASHBOARD, // All values with their tags and the trend charts
+    DISPLAY_FACE_CO2        // Only the CO2 concentration
+} display_face_t;
+
+/**
+ * @brief Display modes, picked from the battery level and how long the shown values have been stable
+ *
+ */
+typedef enum
+{
+    DISPLAY_MODE_ACTIVE,
+    DISPLAY_MODE_STABLE,
+    DISPLAY_MODE_LOW_BATTERY,
+    NUM_DISPLAY_MODES
+} display_mode_t;
+
+/**
+ * @brief How to update the display in a mode
+ *
+ */
+typedef struct
+{
+    display_mode_t mode;
+    display_face_t face;
+    uint32_t min_interval_s;   // Minimum time between refreshes, changes in between wait for the next refresh
+    uint32_t damage_threshold; // Ghosting damage forcing a full refresh
+    bool opportunistic_full;   // Fully refresh a damaged display after a quiet period
+} display_plan_t;
+
+/**
+ * @brief Settings of the display policy, initialized from CONFIG_DISPLAY_POLICY_*
+ *
+ */
+typedef struct
+{
+    uint32_t low_battery_level; // Battery level in percent at or below which the low battery mode is used
+    uint32_t stable_period_s;   // Time without changed values before the stable mode is used
+    uint32_t active_interval_s;
+    uint32_t stable_interval_s;
+    uint32_t low_battery_interval_s;
+    uint32_t low_battery_damage_threshold;
+} display_policy_config_t;
+
+/**
+ * @brief Select how to update the display
+ *
+ * @param battery_level Battery level in percent, -1 if unknown
+ * @param stable_ms Time since the shown values last changed in milliseconds
+ * @return display_plan_t, plan of the selected mode
+ */
+display_plan_t select_display_plan(float battery_level, int64_t stable_ms);
+
+/**
+ * @brief Get the current settings of the display policy
+ *
+ * @param config Filled with the settings
+ */
+void get_display_policy_config(display_policy_config_t *config);
+
+/**
+ * @brief Replace the settings of the display policy, used from the next display update on
+ *
+ * @param config New settings
+ */
+void set_display_policy_config(const display_policy_config_t *config);
+
+/**
+ * @brief Get the name of a display mode
+ *
+ * @param mode Display mode
+ * @return const char*, name of the mode
+ */
+const char *display_mode_to_string(display_mode_t mode);
+
+#endif // DISPLAY_POLICY_H
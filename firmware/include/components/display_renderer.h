@@ -0,0 +1,123 @@
+#ifndef DISPLAY_RENDERER_H
+#define DISPLAY_RENDERER_H
+
+#include <zephyr/device.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RENDERER_CHART_MAX_WIDTH 32
+
+/**
+ * @brief Text fields of the display
+ *
+ */
+typedef enum
+{
+    FIELD_NOTIFICATION,
+    FIELD_TEMPERATURE_TAG,
+    FIELD_TEMPERATURE_VALUE,
+    FIELD_HUMIDITY_TAG,
+    FIELD_HUMIDITY_VALUE,
+    FIELD_CO2_TAG,
+    FIELD_CO2_VALUE,
+    FIELD_VOC_TAG,
+    FIELD_VOC_VALUE,
+    FIELD_BATTERY_TAG,
+    FIELD_BATTERY_VALUE,
+    NUM_DISPLAY_FIELDS
+} display_field_t;
+
+typedef enum
+{
+    FIELD_ALIGN_CENTER,
+    FIELD_ALIGN_TOP_LEFT,
+    FIELD_ALIGN_TOP_RIGHT
+} field_align_t;
+
+/**
+ * @brief Position of a field on the rotated screen, same meaning as the LVGL alignment and offsets
+ *
+ */
+typedef struct
+{
+    uint8_t font_size; // 16, 24 or 32 px
+    field_align_t align;
+    int16_t x;
+    int16_t y;
+} field_layout_t;
+
+/**
+ * @brief Trend charts of the display
+ *
+ */
+typedef enum
+{
+    CHART_TEMPERATURE,
+    CHART_CO2,
+    NUM_DISPLAY_CHARTS
+} display_chart_t;
+
+/**
+ * @brief Area of a bar chart on the rotated screen, one column per value
+ *
+ */
+typedef struct
+{
+    int16_t x;     // Left edge
+    int16_t y;     // Top edge
+    uint8_t width; // Number of columns, at most RENDERER_CHART_MAX_WIDTH
+    uint8_t height;
+} chart_layout_t;
+
+/**
+ * @brief Initialize the renderer backend selected with CONFIG_DISPLAY_RENDERER_*
+ *
+ * @param display_dev Display device
+ * @param layout Layout of the fields, NUM_DISPLAY_FIELDS entries that must stay valid
+ * @param chart_layout Layout of the charts, NUM_DISPLAY_CHARTS entries that must stay valid
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+int renderer_init(const struct device *display_dev, const field_layout_t *layout, const chart_layout_t *chart_layout);
+
+/**
+ * @brief Get the text of a field
+ *
+ * @param field Field
+ * @return const char*, current text
+ */
+const char *renderer_get_text(display_field_t field);
+
+/**
+ * @brief Set the text of a field, drawn on the next flush. The text is not copied, it must stay valid and unchanged
+ * until the field is set again.
+ *
+ * @param field Field
+ * @param text New text
+ */
+void renderer_set_text(display_field_t field, const char *text);
+
+/**
+ * @brief Shift the columns of a chart to the left and append a new column on the right, drawn on the next flush.
+ * Charts start empty and hidden.
+ *
+ * @param chart Chart
+ * @param level Height of the new bar in pixels, 0 for no value, clamped to the chart height
+ */
+void renderer_push_chart(display_chart_t chart, uint8_t level);
+
+/**
+ * @brief Show or hide a chart, the columns are kept while hidden
+ *
+ * @param chart Chart
+ * @param visible True to show the chart
+ */
+void renderer_show_chart(display_chart_t chart, bool visible);
+
+/**
+ * @brief Draw the changed fields and charts and write them to the display
+ *
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+int renderer_flush(void);
+
+#endif // DISPLAY_RENDERER_H
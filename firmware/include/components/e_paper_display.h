@@ -2,6 +2,7 @@
 #define E_PAPER_DISPLAY_H
 
 #include <zephyr/device.h>
+#include <stdint.h>
 
 /**
  * @brief Initialize e-paper display
@@ -11,20 +12,49 @@
 int init_e_paper_display(void);
 
 /**
- * @brief Displayt notification message on e-paper display
+ * @brief Displayt notification message on e-paper display, the refresh runs on the display work queue
  *
- * @param message Message to display
+ * @param message Message to display, copied before returning
  * @return int, 0 if ok, non-zero if an error occured
  */
 int display_notification(const char *message);
 
 /**
- * @brief Update data displayed
+ * @brief Update data displayed. Takes a snapshot of the latest values and returns before the refresh, which runs
+ * on the display work queue.
  *
  * @return int, 0 if ok, non-zero if an error occured
  */
 int update_e_paper_display(void);
 
+/**
+ * @brief Get the number of panel refreshes done
+ *
+ * @return uint32_t, refreshes since boot
+ */
+uint32_t get_display_refreshes(void);
+
+/**
+ * @brief Get the number of refreshes skipped because changed values were held back by the display hysteresis
+ *
+ * @return uint32_t, skipped refreshes since boot
+ */
+uint32_t get_skipped_refreshes(void);
+
+/**
+ * @brief Get the number of refreshes postponed by the refresh interval of the display policy
+ *
+ * @return uint32_t, deferred refreshes since boot
+ */
+uint32_t get_deferred_refreshes(void);
+
+/**
+ * @brief Get the time spent rendering and writing to the panel, without the panel waveform
+ *
+ * @return uint64_t, render time since boot in microseconds
+ */
+uint64_t get_display_render_time_us(void);
+
 /**
  * @brief Suspend e-paper display
  *
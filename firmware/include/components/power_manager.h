@@ -0,0 +1,49 @@
+#ifndef POWER_MANAGER_H
+#define POWER_MANAGER_H
+
+#include <stdint.h>
+
+/**
+ * @brief Enumeration for peripherals powered on demand
+ *
+ */
+typedef enum
+{
+    POWER_SENSORS,
+    POWER_EPD,
+    NUM_POWER_DOMAINS
+} power_domain_t;
+
+/**
+ * @brief Acquire a peripheral, it is resumed if it has no other users
+ *
+ * @param domain Peripheral to acquire
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+int power_get(power_domain_t domain);
+
+/**
+ * @brief Release a peripheral acquired with power_get, it is suspended when the last user releases it
+ *
+ * @param domain Peripheral to release
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+int power_put(power_domain_t domain);
+
+/**
+ * @brief Get the number of resumes and suspends of a peripheral since boot
+ *
+ * @param domain Peripheral
+ * @return uint32_t, number of power transitions
+ */
+uint32_t get_power_transitions(power_domain_t domain);
+
+/**
+ * @brief Get the name of a peripheral
+ *
+ * @param domain Peripheral
+ * @return const char*, name of the peripheral
+ */
+const char *power_domain_to_string(power_domain_t domain);
+
+#endif // POWER_MANAGER_H
@@ -11,7 +11,8 @@
 int init_sensors(void);
 
 /**
- * @brief Read data from each sensor
+ * @brief Read data from each sensor. Each sensor is powered up just in time for its warm-up and measurement
+ * to complete at a common read instant, and powered down right after it is read.
  *
  * @return int, 0 if ok, non-zero if an error occured during any of the reads
  */
@@ -25,10 +26,24 @@ int read_sensors();
 int suspend_sensors(void);
 
 /**
- * @brief Activate the sensors
+ * @brief Stop the SGP40 duty cycle of the low power VOC mode and switch the heater off
+ *
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+int stop_voc_sampling(void);
+
+/**
+ * @brief Activate the sensors, resetting the measurement schedule
  *
  * @return int, 0 if ok, non-zero if an error occured
  */
 int activate_sensors(void);
 
+/**
+ * @brief Save the sensor algorithm states that need to survive a reboot
+ *
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+int save_sensors_state(void);
+
 #endif // SENSORS_H
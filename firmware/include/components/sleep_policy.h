@@ -0,0 +1,32 @@
+#ifndef SLEEP_POLICY_H
+#define SLEEP_POLICY_H
+
+#include <stdint.h>
+
+/**
+ * @brief Enumeration for sleep levels between periodic tasks, deeper levels save more but take longer to resume
+ *
+ */
+typedef enum
+{
+    SLEEP_KERNEL_IDLE, // Peripherals suspended by the state actions, the kernel idles until the next task
+    SLEEP_RADIO_OFF    // Also the BLE controller is disabled, enabled again before the next advertisement
+} sleep_level_t;
+
+/**
+ * @brief Select the sleep level for the idle gap before the next periodic task
+ *
+ * @param gap_ms Time until the next periodic task in milliseconds
+ * @return sleep_level_t, the deepest level worth entering for the gap
+ */
+sleep_level_t select_sleep_level(int64_t gap_ms);
+
+/**
+ * @brief Enter the sleep level selected for the idle gap before the next periodic task
+ *
+ * @param gap_ms Time until the next periodic task in milliseconds
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+int enter_sleep(int64_t gap_ms);
+
+#endif // SLEEP_POLICY_H
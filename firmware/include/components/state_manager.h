@@ -1,6 +1,8 @@
 #ifndef STATE_MANAGER_H
 #define STATE_MANAGER_H
 
+#include <stdint.h>
+
 /**
  * @brief Enumeration for states
  *
@@ -14,9 +16,23 @@ typedef enum
     UPDATING,
     ADVERTISING,
     IDLE,
-    ERROR
+    ERROR,
+    SAMPLING // SGP40 duty cycle bursts, only accounted alongside the other states
 } state_t;
 
+/**
+ * @brief Time and charge accounted to a state since boot
+ *
+ */
+typedef struct
+{
+    uint32_t entries;    // Times the state was entered
+    int64_t total_ms;    // Time spent in the state, including the ongoing visit
+    int64_t mean_ms;     // Mean duration of the finished visits
+    int64_t max_ms;      // Longest finished visit
+    uint32_t charge_uah; // Charge consumed in the state, estimated from its configured current
+} state_stats_t;
+
 /**
  * @brief Set the state object
  *
@@ -31,4 +47,40 @@ void set_state(state_t new_state);
  */
 state_t get_system_state(void);
 
+/**
+ * @brief Get the name of a state
+ *
+ * @param state State
+ * @return const char*, name of the state
+ */
+const char *state_to_string(state_t state);
+
+#ifdef CONFIG_STATE_STATS
+/**
+ * @brief Get the time and charge accounted to a state since boot
+ *
+ * @param state State
+ * @param stats Output for the statistics
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+int get_state_stats(state_t state, state_stats_t *stats);
+
+/**
+ * @brief Estimate the charge consumed per day from the charge consumed since boot
+ *
+ * @return uint32_t, charge in microampere hours per day
+ */
+uint32_t get_daily_charge_uah(void);
+
+/**
+ * @brief Account a visit to a state that ran alongside the current state, e.g. a display refresh on its own
+ * work queue. Its time is not charged to the current state as well, except for SAMPLING which only adds the SGP40
+ * heater current.
+ *
+ * @param state State visited
+ * @param duration_ms Duration of the visit
+ */
+void record_parallel_state(state_t state, int64_t duration_ms);
+#endif
+
 #endif // STATE_MANAGER_H
\ No newline at end of file
@@ -94,6 +94,13 @@
 
 #define BMP390_START_UP_WAIT_TIME_MS 2
 
+/* Bound of the float compensated pressure, well above the 1250 hPa full scale */
+#define BMP390_PRESS_MAX_PA 200000.0f
+
+/* Configuration registers PWR_CTRL..CONFIG are shadowed in the driver data */
+#define BMP390_SHADOW_IDX(reg) ((reg) - BMP390_REG_PWR_CTRL)
+#define BMP390_SHADOW_SIZE (BMP390_SHADOW_IDX(BMP390_REG_CONFIG) + 1)
+
 typedef struct
 {
 	uint16_t t1;
@@ -112,6 +119,30 @@ typedef struct
 	int8_t p11;
 } __packed bmp390_cal_data_t;
 
+#ifdef CONFIG_BMP390_FLOAT_COMPENSATION
+/**
+ * @brief BMP390 calibration coefficients scaled for float compensation.
+ *
+ */
+typedef struct
+{
+	float t1;
+	float t2;
+	float t3;
+	float p1;
+	float p2;
+	float p3;
+	float p4;
+	float p5;
+	float p6;
+	float p7;
+	float p8;
+	float p9;
+	float p10;
+	float p11;
+} bmp390_float_cal_data_t;
+#endif
+
 /**
  * @brief BMP390 mode of operation.
  *
@@ -148,8 +179,26 @@ typedef struct
 	uint32_t t_sample;
 	int64_t comp_temp;
 	bmp390_cal_data_t cal;
+#ifdef CONFIG_BMP390_FLOAT_COMPENSATION
+	float comp_temp_f;
+	bmp390_float_cal_data_t cal_f;
+#endif
+	uint8_t shadow[BMP390_SHADOW_SIZE];
+	uint8_t shadow_valid;
+	uint32_t writes_issued;
+	uint32_t writes_elided;
 } bmp390_data_t;
 
+/**
+ * @brief BMP390 register write statistics.
+ *
+ */
+typedef struct
+{
+	uint32_t issued;
+	uint32_t elided;
+} bmp390_bus_stats_t;
+
 typedef enum
 {
 	SENSOR_ATTR_BMP390_SAMPLING_RATE,
@@ -157,4 +206,12 @@ typedef enum
 	SENSOR_ATTR_BMP390_COMPENSATION,
 } sensor_attribute_bmp390;
 
+/**
+ * @brief Get the number of register writes issued to the sensor and elided by the register shadow
+ *
+ * @param dev BMP390 device
+ * @param stats Output for the statistics
+ */
+void bmp390_get_bus_stats(const struct device *dev, bmp390_bus_stats_t *stats);
+
 #endif // BMP390_H
\ No newline at end of file
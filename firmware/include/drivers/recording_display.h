@@ -0,0 +1,28 @@
+#ifndef RECORDING_DISPLAY_H
+#define RECORDING_DISPLAY_H
+
+#include <zephyr/device.h>
+#include <stdint.h>
+
+/**
+ * @brief Display traffic recorded since boot. Like on the SSD16xx, a write refreshes the panel partially unless the
+ * display is blanked, turning blanking off refreshes it fully.
+ *
+ */
+typedef struct
+{
+    uint32_t writes;
+    uint64_t bytes; // Bytes written
+    uint32_t partial_refreshes;
+    uint32_t full_refreshes;
+} recording_display_stats_t;
+
+/**
+ * @brief Get the display traffic recorded so far
+ *
+ * @param dev Recording display device
+ * @param stats Filled with the recorded traffic
+ */
+void recording_display_get_stats(const struct device *dev, recording_display_stats_t *stats);
+
+#endif // RECORDING_DISPLAY_H
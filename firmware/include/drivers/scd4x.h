@@ -3,6 +3,7 @@
 
 #include <zephyr/device.h>
 #include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/sensor.h>
 
 #define SCD4X_CMD_START_PERIODIC_MEASUREMENT 0x21B1
 #define SCD4X_CMD_READ_MEASUREMENT 0xEC05
@@ -37,16 +38,9 @@
 
 #define SCD4X_TEST_OK 0x0000
 
-#define SCD4X_STOP_PERIODIC_MEASUREMENT_WAIT_MS 500
-#define SCD4X_FORCED_CALIBRATION_WAIT_MS 400
-#define SCD4X_PERSIST_SETTINGS_WAIT_MS 800
-#define SCD4X_TEST_WAIT_MS 10000
-#define SCD4X_FACTORY_RESET_WAIT_MS 1200
-#define SCD4X_REINIT_WAIT_MS 30
-#define SCD4X_MEASURE_SINGLE_SHOT_WAIT_MS 5000
-#define SCD4X_MEASURE_SINGLE_SHOT_RHT_ONLY_WAIT_MS 50
-#define SCD4X_WAKE_UP_WAIT_MS 30
-#define SCD4X_DEFAULT_WAIT_MS 1
+/* Single shot measurement durations */
+#define SCD4X_SINGLE_SHOT_TIME_MS 5000
+#define SCD4X_SINGLE_SHOT_RHT_ONLY_TIME_MS 50
 
 /*
  * CRC parameters were taken from the
@@ -99,19 +93,44 @@ typedef struct
 	scd4x_mode_t mode;
 	scd4x_model_t model;
 	bool selftest;
+	uint16_t ambient_pressure_tolerance;
 } scd4x_config_t;
 
 /**
  * @brief SCD4X data structure.
  *
+ * In the single shot modes, fetching SENSOR_CHAN_AMBIENT_TEMP or SENSOR_CHAN_HUMIDITY
+ * runs the RH/T only single shot and leaves the previous CO2 sample untouched.
  */
 typedef struct
 {
 	uint16_t co2_sample;
 	uint16_t t_sample;
 	uint16_t rh_sample;
+#ifdef CONFIG_SCD4X_BUS_TIMING
+	uint32_t bus_cycles;
+#endif
+	/* Shadow copies of the attributes written to the sensor */
+	uint16_t attr_shadow[6];
+	uint8_t attr_shadow_valid;
+	int32_t ambient_pressure_shadow;
+	uint32_t attr_writes_issued;
+	uint32_t attr_writes_elided;
+	/* Single shot started with scd4x_start_single_shot(), 0 if none */
+	uint16_t pending_cmd;
+	int64_t pending_ready_ms;
 } scd4x_data_t;
 
+/**
+ * @brief SCD4X attribute write statistics.
+ *
+ */
+typedef struct
+{
+	uint32_t issued;
+	uint32_t elided;
+} scd4x_bus_stats_t;
+
 typedef enum
 {
 	/* Offset temperature: Toffset_actual = Tscd4x – Treference + Toffset_previous
@@ -145,4 +164,25 @@ typedef enum
 	SENSOR_ATTR_SCD4X_SELF_CALIB_STANDARD_PERIOD,
 } sensor_attribute_scd4x;
 
+/**
+ * @brief Start a single shot measurement without waiting for it to complete
+ *
+ * The next sample fetch waits for the remaining measurement time, if any, and reads the result.
+ *
+ * @param dev SCD4X device
+ * @param chan SENSOR_CHAN_AMBIENT_TEMP or SENSOR_CHAN_HUMIDITY for a RH/T only measurement,
+ * any other channel for a full measurement
+ * @param ready_in_ms Output for the time until the measurement is ready
+ * @return int, 0 if ok, -ENOTSUP if not in a single shot mode, other non-zero if an error occured
+ */
+int scd4x_start_single_shot(const struct device *dev, enum sensor_channel chan, uint32_t *ready_in_ms);
+
+/**
+ * @brief Get the number of attribute writes issued to the sensor and elided by the attribute shadow
+ *
+ * @param dev SCD4X device
+ * @param stats Output for the statistics
+ */
+void scd4x_get_bus_stats(const struct device *dev, scd4x_bus_stats_t *stats);
+
 #endif // SCD4X_H
\ No newline at end of file
@@ -0,0 +1,11 @@
+#ifndef BATTERY_ESTIMATE_H
+#define BATTERY_ESTIMATE_H
+
+/**
+ * @brief Print the per state charge breakdown and the battery life projected from the state statistics since boot
+ *
+ * @return int, 0 if ok, non-zero if no charge was accounted
+ */
+int print_battery_estimate(void);
+
+#endif // BATTERY_ESTIMATE_H
@@ -0,0 +1,86 @@
+#ifndef BITMAP_FONT_H
+#define BITMAP_FONT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * 1-bpp glyph bitmaps for the direct display renderer, generated with scripts/font_converter.py at build time.
+ * Rows are stored top row first as one continuous bit stream, MSB first. Compressed glyphs XOR each row with the
+ * previous one and store the bits as alternating runs of zeros and ones, starting with zeros. A run length is a
+ * sequence of nibbles, high nibble first, ended by the first nibble below 15.
+ */
+
+#define BITMAP_FONT_MAX_ROW_BYTES 8
+
+typedef struct
+{
+    uint16_t bitmap_index; // Byte offset of the glyph in the font bitmap
+    uint8_t code;          // Latin-1 character code
+    uint8_t adv_w;         // Advance width in pixels
+    uint8_t box_w;
+    uint8_t box_h;
+    int8_t ofs_x; // Left edge of the box relative to the pen position
+    int8_t ofs_y; // Bottom edge of the box relative to the baseline
+} bitmap_glyph_t;
+
+typedef struct
+{
+    const uint8_t *bitmap;
+    const bitmap_glyph_t *glyphs; // Sorted by code
+    uint8_t glyph_count;
+    uint8_t line_height;
+    uint8_t base_line; // Baseline measured from the bottom of the line
+    bool compressed;
+} bitmap_font_t;
+
+/**
+ * @brief Reads the rows of a glyph one after another
+ *
+ */
+typedef struct
+{
+    const bitmap_font_t *font;
+    const bitmap_glyph_t *glyph;
+    uint32_t position; // Next bit of an uncompressed glyph, next nibble of a compressed one
+    uint16_t run;      // Pixels left in the current run
+    bool color;        // Color of the current run
+    uint8_t row[BITMAP_FONT_MAX_ROW_BYTES];
+} bitmap_glyph_reader_t;
+
+/**
+ * @brief Find the glyph of a character
+ *
+ * @param font Font
+ * @param code Latin-1 character code
+ * @return const bitmap_glyph_t*, glyph or NULL if the font does not have the character
+ */
+const bitmap_glyph_t *bitmap_font_find_glyph(const bitmap_font_t *font, uint8_t code);
+
+/**
+ * @brief Get the width of a text, characters missing from the font are skipped
+ *
+ * @param font Font
+ * @param text Latin-1 text
+ * @return int, width in pixels
+ */
+int bitmap_font_text_width(const bitmap_font_t *font, const char *text);
+
+/**
+ * @brief Start reading the rows of a glyph
+ *
+ * @param reader Reader to initialize
+ * @param font Font of the glyph
+ * @param glyph Glyph
+ */
+void bitmap_glyph_reader_init(bitmap_glyph_reader_t *reader, const bitmap_font_t *font, const bitmap_glyph_t *glyph);
+
+/**
+ * @brief Read the next row of a glyph, call at most box_h times
+ *
+ * @param reader Reader
+ * @return const uint8_t*, pixels of the row MSB first, valid until the next call
+ */
+const uint8_t *bitmap_glyph_read_row(bitmap_glyph_reader_t *reader);
+
+#endif // BITMAP_FONT_H
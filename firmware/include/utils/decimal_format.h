@@ -0,0 +1,20 @@
+#ifndef DECIMAL_FORMAT_H
+#define DECIMAL_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Write a fixed point number as decimal text followed by a suffix, a small replacement for snprintf with
+ * "%d" conversions that does not pull in the printf implementation
+ *
+ * @param buf Output buffer
+ * @param size Size of the output buffer, the text is truncated to fit
+ * @param value Value in units of the last decimal, e.g. 234 for 23.4 with one decimal
+ * @param decimals Number of digits after the decimal point
+ * @param suffix Text written after the number, e.g. a unit
+ * @return size_t, length of the text
+ */
+size_t format_decimal(char *buf, size_t size, int32_t value, uint8_t decimals, const char *suffix);
+
+#endif // DECIMAL_FORMAT_H
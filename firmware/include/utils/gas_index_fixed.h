@@ -0,0 +1,101 @@
+#ifndef GAS_INDEX_FIXED_H
+#define GAS_INDEX_FIXED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Fixed-point port of the Sensirion gas index algorithm (VOC only, default tuning). Follows
+ * sensirion_gas_index_algorithm.c step by step with the estimator rates and sigmoid outputs kept as fractions in Q2.30,
+ * the indices stay within +-1 of the float version. For targets without an FPU where the float version pulls in
+ * soft-float expf/sqrtf on every sample, the processing only uses 32 and 64-bit integer multiplications and shifts.
+ */
+
+typedef int32_t fix16_t; // Q16.16, values in sraw ticks, index points and seconds
+typedef int32_t fix30_t; // Q2.30, fractions
+
+typedef struct
+{
+    int32_t sampling_interval_s;
+    fix16_t sampling_interval;
+    fix16_t uptime;
+    fix16_t sraw;
+    fix16_t gas_index;
+
+    // Mean variance estimator, the rates are the fractions of the float version without the gamma scalings
+    bool mve_initialized;
+    fix16_t mve_mean;
+    fix16_t mve_sraw_offset;
+    fix16_t mve_std;
+    fix30_t mve_gamma_mean_base;
+    fix30_t mve_gamma_variance_base;
+    fix30_t mve_gamma_initial_mean;
+    fix30_t mve_gamma_initial_variance;
+    fix30_t mve_gamma_mean;
+    fix30_t mve_gamma_variance;
+    fix16_t mve_uptime_gamma;
+    fix16_t mve_uptime_gating;
+    fix16_t mve_gating_duration_s;
+
+    // Mox model
+    fix16_t mox_sraw_mean;
+    fix30_t mox_scale; // Index gain over the std plus bonus
+
+    // Adaptive lowpass
+    bool lp_initialized;
+    fix30_t lp_a1;
+    fix30_t lp_a2;
+    fix16_t lp_x1;
+    fix16_t lp_x2;
+    fix16_t lp_x3;
+} gas_index_fixed_params_t;
+
+/**
+ * @brief Initialize the VOC gas index algorithm
+ *
+ * @param params Algorithm parameters to initialize
+ * @param sampling_interval_s Interval between two processed samples in seconds
+ */
+void gas_index_fixed_init(gas_index_fixed_params_t *params, int32_t sampling_interval_s);
+
+/**
+ * @brief Process a raw VOC ticks sample
+ *
+ * @param params Algorithm parameters
+ * @param sraw Raw ticks from the SGP40
+ * @param gas_index Calculated VOC index (1 - 500), 0 during the initial blackout
+ */
+void gas_index_fixed_process(gas_index_fixed_params_t *params, int32_t sraw, int32_t *gas_index);
+
+/**
+ * @brief Process consecutive raw VOC ticks samples, e.g. a burst or stored samples replayed after a restore.
+ * Gives the same indices as calling gas_index_fixed_process for each sample.
+ *
+ * @param params Algorithm parameters
+ * @param sraw Raw ticks from the SGP40, oldest first
+ * @param gas_index Calculated VOC indices, one per sample
+ * @param count Number of samples
+ */
+void gas_index_fixed_process_batch(gas_index_fixed_params_t *params, const int32_t *sraw, int32_t *gas_index,
+                                   size_t count);
+
+/**
+ * @brief Get the algorithm states, same format as GasIndexAlgorithm_get_states
+ *
+ * @param params Algorithm parameters
+ * @param state0 Mean state
+ * @param state1 Standard deviation state
+ */
+void gas_index_fixed_get_states(const gas_index_fixed_params_t *params, float *state0, float *state1);
+
+/**
+ * @brief Set previously retrieved algorithm states, same format as GasIndexAlgorithm_set_states
+ *
+ * @param params Algorithm parameters
+ * @param state0 Mean state
+ * @param state1 Standard deviation state
+ */
+void gas_index_fixed_set_states(gas_index_fixed_params_t *params, float state0, float state1);
+
+#endif // GAS_INDEX_FIXED_H
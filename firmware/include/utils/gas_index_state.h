@@ -0,0 +1,35 @@
+#ifndef GAS_INDEX_STATE_H
+#define GAS_INDEX_STATE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Get the gas index algorithm states loaded from settings, if the checkpoint is still usable.
+ * Call after settings have been loaded and set the states to the initialized algorithm.
+ *
+ * @param state0 Restored mean state
+ * @param state1 Restored standard deviation state
+ * @return int, 0 if the states can be restored, non-zero if the algorithm starts learning from scratch
+ */
+int restore_gas_index_state(float *state0, float *state1);
+
+/**
+ * @brief Count a processed sample and checkpoint the algorithm states to settings when due
+ *
+ * @param sampling_interval_s Sampling interval of the algorithm in seconds
+ * @param state0 Current mean state
+ * @param state1 Current standard deviation state
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+int update_gas_index_state(uint32_t sampling_interval_s, float state0, float state1);
+
+/**
+ * @brief Save the algorithm states to settings right away, e.g. on a controlled shutdown
+ *
+ * @param state0 Current mean state
+ * @param state1 Current standard deviation state
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+int save_gas_index_state(float state0, float state1);
+
+#endif // GAS_INDEX_STATE_H
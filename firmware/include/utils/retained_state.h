@@ -0,0 +1,59 @@
+#ifndef RETAINED_STATE_H
+#define RETAINED_STATE_H
+
+#include <utils/variable_buffer.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Minimal measurement state kept in RAM that is not cleared at boot. It survives resets as long as the RAM
+// stays powered (reset pin, fatal error reset, watchdog), but not a power loss.
+typedef struct
+{
+    uint32_t layout;     // Changes with the structure, rejects the state after a firmware update
+    uint32_t boot_count; // Warm boots since the last cold boot
+    uint32_t epoch;      // Measurement cycles since the last cold boot
+    float buffers[NUM_VARIABLES][CONFIG_MEASUREMENTS_PER_INTERVAL];
+    uint16_t buffer_index[NUM_VARIABLES];
+    float gas_index_state0;
+    float gas_index_state1;
+    uint32_t gas_index_learning_time_s;
+    uint32_t cold_ready_ms; // Boot to first measurement of the last cold boot
+    uint32_t warm_ready_ms; // Boot to first measurement of the last warm boot
+    uint32_t crc;
+} retained_state_t;
+
+/**
+ * @brief Get the retained state for reading. Modify it between lock_retained_state and unlock_retained_state.
+ *
+ * @return retained_state_t*, pointer to the retained state
+ */
+retained_state_t *get_retained_state(void);
+
+/**
+ * @brief Lock the retained state for modification, the measurement thread and the system work queue both write it
+ *
+ * @return retained_state_t*, pointer to the retained state
+ */
+retained_state_t *lock_retained_state(void);
+
+/**
+ * @brief Update the CRC of the modified retained state and unlock it
+ */
+void unlock_retained_state(void);
+
+/**
+ * @brief Check whether the retained state was restored from before the last reset
+ *
+ * @return true if warm restored, false after a cold boot
+ */
+bool retained_state_is_warm(void);
+
+/**
+ * @brief Record the time from boot to the first measurement, kept for the last cold and the last warm boot
+ *
+ * @param ready_ms Uptime at the first measurement
+ */
+void record_boot_to_ready(int64_t ready_ms);
+
+#endif // RETAINED_STATE_H
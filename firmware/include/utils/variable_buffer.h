@@ -46,6 +46,16 @@ void free_buffers(void);
  */
 void set_value(variable_t variable, float value);
 
+#ifdef CONFIG_RETAINED_STATE
+/**
+ * @brief Copy the buffers to the retained state, once per measurement cycle while it is locked
+ *
+ * @param data Retained buffer data
+ * @param indices Retained buffer indices
+ */
+void save_buffers(float data[][CONFIG_MEASUREMENTS_PER_INTERVAL], uint16_t *indices);
+#endif
+
 /**
  * @brief Get the mean value of a buffer
  *
@@ -0,0 +1,157 @@
+#!/usr/bin/env python3
+"""
+Convert the frames printed by the recording display on native_sim (CONFIG_RECORDING_DISPLAY_DUMP_FRAMES) into
+images, and optionally compare them with reference images.
+
+The recording display holds the panel content in the SSD16xx layout: vertically tiled, a byte holds 8 rows of one
+column with the topmost row in the MSB, a set bit is black. The panel is mounted rotated by 90 degrees, the images
+are written the way the screen is read, one binary PBM file per refresh named frame_NNNN.pbm.
+
+Log lines printed in the middle of a frame are skipped.
+
+Usage:
+    build/zephyr/zephyr.exe > estimator.log
+    python display_frames.py estimator.log frames
+    python display_frames.py estimator.log frames --compare golden
+
+Reference images are created by converting a known good log into the reference directory, plain and binary PBM
+files are read.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+FRAME_START = re.compile(r"FRAME (\d+) (full|partial) (\d+) (\d+)")
+HEX_LINE = re.compile(r"^[0-9a-f]+$")
+
+
+class Frame:
+    def __init__(self, number, kind, width, height):
+        self.number = number
+        self.kind = kind
+        self.width = width  # Panel width, the screen height
+        self.height = height  # Panel height, the screen width
+        self.data = bytearray()
+
+    def screen(self):
+        """Rows of screen pixels, 1 is black"""
+        rows = []
+        for y in range(self.width):
+            row = []
+            for x in range(self.height):
+                panel_x = y
+                panel_y = self.height - 1 - x
+                byte = self.data[(panel_y // 8) * self.width + panel_x]
+                row.append((byte >> (7 - panel_y % 8)) & 1)
+            rows.append(row)
+        return rows
+
+
+def parse_frames(path):
+    frames = []
+    frame = None
+    with open(path, encoding="utf-8", errors="replace") as log:
+        for line in log:
+            line = line.strip()
+            if frame is None:
+                match = FRAME_START.search(line)
+                if match:
+                    frame = Frame(int(match[1]), match[2], int(match[3]), int(match[4]))
+            elif line == "END":
+                if len(frame.data) != frame.width * frame.height // 8:
+                    sys.exit(f"Frame {frame.number} has {len(frame.data)} bytes, "
+                             f"expected {frame.width * frame.height // 8}")
+                frames.append(frame)
+                frame = None
+            elif HEX_LINE.match(line) and len(line) % 2 == 0:
+                frame.data += bytes.fromhex(line)
+    if frame is not None:
+        sys.exit(f"Frame {frame.number} is not terminated")
+    return frames
+
+
+def write_pbm(path, rows):
+    """Binary PBM, rows are padded to whole bytes with the leftmost pixel in the MSB"""
+    width = len(rows[0])
+    with open(path, "wb") as out:
+        out.write(f"P4\n{width} {len(rows)}\n".encode("ascii"))
+        for row in rows:
+            packed = bytearray((width + 7) // 8)
+            for x, pixel in enumerate(row):
+                packed[x // 8] |= pixel << (7 - x % 8)
+            out.write(packed)
+
+
+def read_pbm(path):
+    with open(path, "rb") as pbm:
+        content = pbm.read()
+    if content[:2] == b"P4":
+        # Magic, width and height separated by whitespace, then a single whitespace before the pixels
+        header = re.match(rb"P4\s+(?:#[^\n]*\n\s*)*(\d+)\s+(?:#[^\n]*\n\s*)*(\d+)\s", content)
+        if header is None:
+            sys.exit(f"{path} has an invalid PBM header")
+        width, height = int(header[1]), int(header[2])
+        stride = (width + 7) // 8
+        data = content[header.end():]
+        if len(data) < stride * height:
+            sys.exit(f"{path} is truncated")
+        return [[(data[y * stride + x // 8] >> (7 - x % 8)) & 1 for x in range(width)] for y in range(height)]
+    if content[:2] != b"P1":
+        sys.exit(f"{path} is not a PBM file")
+    tokens = [token for line in content.decode("ascii").splitlines() for token in line.split("#")[0].split()]
+    width, height = int(tokens[1]), int(tokens[2])
+    # Pixels may be written without separators
+    pixels = [int(c) for token in tokens[3:] for c in token]
+    return [pixels[y * width:(y + 1) * width] for y in range(height)]
+
+
+def count_differences(rows, reference):
+    if len(rows) != len(reference) or len(rows[0]) != len(reference[0]):
+        return None
+    return sum(a != b for row, ref_row in zip(rows, reference) for a, b in zip(row, ref_row))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("log", help="Output of the native_sim executable")
+    parser.add_argument("output", help="Directory for the frame images")
+    parser.add_argument("--compare", metavar="DIR", help="Directory of reference images to compare the frames with")
+    args = parser.parse_args()
+
+    frames = parse_frames(args.log)
+    if not frames:
+        sys.exit("No frames found, is CONFIG_RECORDING_DISPLAY_DUMP_FRAMES enabled?")
+
+    os.makedirs(args.output, exist_ok=True)
+    mismatches = 0
+    for frame in frames:
+        name = f"frame_{frame.number:04d}.pbm"
+        rows = frame.screen()
+        write_pbm(os.path.join(args.output, name), rows)
+        if args.compare is None:
+            continue
+
+        reference_path = os.path.join(args.compare, name)
+        if not os.path.exists(reference_path):
+            print(f"{name}: no reference image")
+            mismatches += 1
+            continue
+        differences = count_differences(rows, read_pbm(reference_path))
+        if differences is None:
+            print(f"{name}: size differs from the reference image")
+            mismatches += 1
+        elif differences > 0:
+            print(f"{name}: {differences} pixels differ ({frame.kind} refresh)")
+            mismatches += 1
+
+    full = sum(frame.kind == "full" for frame in frames)
+    print(f"{len(frames)} frames ({full} full, {len(frames) - full} partial) written to {args.output}")
+    if args.compare is not None:
+        print(f"{mismatches} frames differ from {args.compare}")
+        sys.exit(1 if mismatches > 0 else 0)
+
+
+if __name__ == "__main__":
+    main()
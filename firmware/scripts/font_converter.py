@@ -0,0 +1,408 @@
+#!/usr/bin/env python3
+"""
+Generate the display fonts from a 1-bpp LVGL font (lv_font_conv C output), subset to the characters the display
+shows. Run by CMakeLists.txt at build time.
+
+The glyphs are scaled from the source size with area sampling, so all sizes are generated from the single 64 px
+Montserrat source in fonts/. The degree sign is not part of the source range, it is built from a scaled down "o"
+placed at cap height.
+
+The characters of a font are given directly or taken from the string literals of C functions, e.g. the functions
+setting the texts shown with the font. Literals inside LOG_* calls are skipped and printf conversions are expanded
+to the characters they can print.
+
+Output formats:
+    direct  Header with bitmap_font_t fonts for the direct renderer, optionally RLE compressed
+    lvgl    C source with lv_font_t fonts for the LVGL renderer
+
+Usage:
+    python font_converter.py SOURCE OUTPUT --format direct --rle \\
+        --font NAME:SIZE --chars NAME=CHARS --chars-from NAME=FILE:FUNCTION[,FUNCTION] ...
+
+CHARS may use Python escapes, e.g. "0123456789.%\\xb0C".
+"""
+
+import argparse
+import math
+import re
+import sys
+
+DEGREE = 0xB0
+SUPERSAMPLING = 4
+MAX_BOX_WIDTH = 64  # BITMAP_FONT_MAX_ROW_BYTES * 8
+RLE_MAX_NIBBLE = 15
+
+# Characters printf conversions can produce
+CONVERSIONS = {"d": "-0123456789", "i": "-0123456789", "u": "0123456789", "f": "-.0123456789", "%": "%"}
+
+
+class Glyph:
+    def __init__(self, adv_w, ofs_x, ofs_y, rows):
+        self.adv_w = adv_w  # Advance width in pixels, may be fractional before rounding
+        self.ofs_x = ofs_x  # Left edge relative to the pen position
+        self.ofs_y = ofs_y  # Bottom edge relative to the baseline
+        self.rows = rows  # Rows of 0/1 pixels, top row first
+
+    @property
+    def box_w(self):
+        return len(self.rows[0]) if self.rows else 0
+
+    @property
+    def box_h(self):
+        return len(self.rows)
+
+
+def parse_source(path):
+    """Parse glyph bitmaps, descriptors, cmaps and metrics of an uncompressed 1-bpp lv_font_conv font"""
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+
+    if not re.search(r"\.bpp\s*=\s*1\b", text):
+        sys.exit("Only 1-bpp fonts are supported")
+
+    bitmap_text = re.search(r"glyph_bitmap\[\]\s*=\s*\{(.*?)\};", text, re.S).group(1)
+    bitmap_text = re.sub(r"/\*.*?\*/", "", bitmap_text, flags=re.S)
+    bitmap = [int(value, 16) for value in re.findall(r"0x[0-9a-fA-F]+", bitmap_text)]
+
+    descriptors = [
+        {key: int(value) for key, value in re.findall(r"\.(\w+)\s*=\s*(-?\d+)", entry)}
+        for entry in re.findall(r"\{(\.bitmap_index[^}]*)\}", text)
+    ]
+
+    codes = {}
+    for cmap in re.findall(r"\{(\.range_start[^}]*)\}", text):
+        fields = dict(re.findall(r"\.(\w+)\s*=\s*([\w-]+)", cmap))
+        if fields["type"] != "LV_FONT_FMT_TXT_CMAP_FORMAT0_TINY":
+            sys.exit("Only FORMAT0_TINY cmaps are supported")
+        for i in range(int(fields["range_length"])):
+            codes[int(fields["range_start"]) + i] = int(fields["glyph_id_start"]) + i
+
+    size = int(re.search(r"Size:\s*(\d+)", text).group(1))
+    line_height = int(re.search(r"\.line_height\s*=\s*(\d+)", text).group(1))
+    base_line = int(re.search(r"\.base_line\s*=\s*(\d+)", text).group(1))
+
+    glyphs = {}
+    for code, glyph_id in codes.items():
+        dsc = descriptors[glyph_id]
+        bit = dsc["bitmap_index"] * 8
+        rows = []
+        for _ in range(dsc["box_h"]):
+            row = []
+            for _ in range(dsc["box_w"]):
+                row.append((bitmap[bit // 8] >> (7 - bit % 8)) & 1)
+                bit += 1
+            rows.append(row)
+        # Advance width is stored in 1/16 pixels
+        glyphs[code] = Glyph(dsc["adv_w"] / 16, dsc["ofs_x"], dsc["ofs_y"], rows)
+
+    if DEGREE not in glyphs:
+        glyphs[DEGREE] = make_degree(glyphs)
+
+    return size, line_height, base_line, glyphs
+
+
+def scale_glyph(glyph, factor):
+    """Scale a glyph by area sampling, a pixel is set if at least half of it is covered"""
+    if glyph.box_w == 0 or glyph.box_h == 0:
+        return Glyph(glyph.adv_w * factor, 0, 0, [])
+
+    top = glyph.ofs_y + glyph.box_h
+    x0 = math.floor(glyph.ofs_x * factor)
+    x1 = math.ceil((glyph.ofs_x + glyph.box_w) * factor)
+    y0 = math.floor(glyph.ofs_y * factor)
+    y1 = math.ceil(top * factor)
+
+    rows = []
+    for y in range(y1 - 1, y0 - 1, -1):
+        row = []
+        for x in range(x0, x1):
+            covered = 0
+            for sy in range(SUPERSAMPLING):
+                for sx in range(SUPERSAMPLING):
+                    # Sample point in source coordinates, y up from the baseline
+                    px = (x + (sx + 0.5) / SUPERSAMPLING) / factor - glyph.ofs_x
+                    py = top - (y + (sy + 0.5) / SUPERSAMPLING) / factor
+                    col, line = int(math.floor(px)), int(math.floor(py))
+                    if 0 <= col < glyph.box_w and 0 <= line < glyph.box_h:
+                        covered += glyph.rows[line][col]
+            row.append(1 if covered * 2 >= SUPERSAMPLING * SUPERSAMPLING else 0)
+        rows.append(row)
+
+    return trim(Glyph(glyph.adv_w * factor, x0, y0, rows))
+
+
+def trim(glyph):
+    """Remove empty rows and columns around the glyph"""
+    rows = glyph.rows
+    while rows and not any(rows[0]):
+        rows = rows[1:]
+    bottom = 0
+    while rows and not any(rows[-1]):
+        rows = rows[:-1]
+        bottom += 1
+    if not rows:
+        return Glyph(glyph.adv_w, 0, 0, [])
+    left = min(row.index(1) for row in rows if any(row))
+    right = max(len(row) - row[::-1].index(1) for row in rows if any(row))
+    rows = [row[left:right] for row in rows]
+    return Glyph(glyph.adv_w, glyph.ofs_x + left, glyph.ofs_y + bottom, rows)
+
+
+def make_degree(glyphs):
+    """Build the degree sign from a half size "o" with its top at the cap height of "C" """
+    ring = scale_glyph(glyphs[ord("o")], 0.5)
+    cap = glyphs[ord("C")]
+    ofs_y = cap.ofs_y + cap.box_h - ring.box_h
+    return Glyph(ring.box_w + 2 * ring.ofs_x, ring.ofs_x, ofs_y, ring.rows)
+
+
+def pack(rows):
+    """Pack rows of pixels into bytes, continuous bits MSB first like lv_font_conv"""
+    bits = [pixel for row in rows for pixel in row]
+    data = []
+    for i in range(0, len(bits), 8):
+        chunk = bits[i:i + 8] + [0] * (8 - len(bits[i:i + 8]))
+        data.append(sum(bit << (7 - n) for n, bit in enumerate(chunk)))
+    return data
+
+
+def pack_rle(rows):
+    """
+    Compress rows of pixels, see bitmap_font.h. Each row is XORed with the previous one, so vertical strokes become
+    runs of zeros, and the bits are stored as alternating runs of zeros and ones starting with zeros. A run length
+    is a sequence of nibbles, high nibble first, ended by the first nibble below 15.
+    """
+    previous = [0] * len(rows[0]) if rows else []
+    bits = []
+    for row in rows:
+        bits += [a ^ b for a, b in zip(row, previous)]
+        previous = row
+
+    runs = []
+    color = 0
+    length = 0
+    for bit in bits:
+        if bit != color:
+            runs.append(length)
+            color = bit
+            length = 0
+        length += 1
+    runs.append(length)
+
+    nibbles = []
+    for length in runs:
+        while length >= RLE_MAX_NIBBLE:
+            nibbles.append(RLE_MAX_NIBBLE)
+            length -= RLE_MAX_NIBBLE
+        nibbles.append(length)
+    if len(nibbles) % 2:
+        nibbles.append(0)
+    return [nibbles[i] << 4 | nibbles[i + 1] for i in range(0, len(nibbles), 2)]
+
+
+def string_literals(path, function):
+    """Characters of the string literals in a C function, except the ones logged"""
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+
+    match = re.search(r"^[\w\s\*]*\b" + function + r"\s*\([^;{]*\)\s*\{", text, re.M)
+    if not match:
+        sys.exit(f"Function {function} not found in {path}")
+    depth = 0
+    for end in range(match.end() - 1, len(text)):
+        depth += {"{": 1, "}": -1}.get(text[end], 0)
+        if depth == 0:
+            break
+    body = re.sub(r"//[^\n]*|/\*.*?\*/", "", text[match.end():end], flags=re.S)
+    body = re.sub(r"\bLOG_\w+\s*\((?:[^()]|\([^()]*\))*\)", "", body)
+
+    chars = ""
+    for literal in re.findall(r'"((?:[^"\\]|\\.)*)"', body):
+        value = re.sub(r"\\x([0-9a-fA-F]{2})", lambda m: chr(int(m.group(1), 16)), literal)
+        value = value.encode("latin-1", "backslashreplace").decode("unicode_escape")
+        # Replace printf conversions by the characters they print
+        for conversion in re.findall(r"%[-+ #0]*\d*(?:\.\d+)?(?:l|ll|h)?([a-z%])", value):
+            chars += CONVERSIONS.get(conversion, "")
+        chars += re.sub(r"%[-+ #0]*\d*(?:\.\d+)?(?:l|ll|h)?[a-z%]", "", value)
+    return chars
+
+
+def build_font(size, source, chars):
+    source_size, line_height, base_line, glyphs = source
+    factor = size / source_size
+
+    codes = sorted(set(ord(char) for char in chars if char != "\n"))
+    missing = [code for code in codes if code not in glyphs]
+    if missing:
+        sys.exit(f"Characters not in the source font: {missing}")
+
+    scaled = {code: scale_glyph(glyphs[code], factor) for code in codes}
+    for code, glyph in scaled.items():
+        if glyph.box_w > MAX_BOX_WIDTH:
+            sys.exit(f"Glyph {code} is wider than {MAX_BOX_WIDTH} px")
+    return scaled, round(line_height * factor), round(base_line * factor)
+
+
+def describe(code):
+    return chr(code) if code < 0x80 else f"U+{code:04X}"
+
+
+def format_bitmap(name, bitmap, qualifier="static const"):
+    lines = [f"{qualifier} uint8_t {name}[] = {{"]
+    for i in range(0, len(bitmap), 12):
+        lines.append("    " + ", ".join(f"0x{value:02x}" for value in bitmap[i:i + 12]) + ",")
+    lines.append("};")
+    return lines
+
+
+def format_direct(name, size, glyphs, line_height, base_line, rle):
+    # Runs of small glyphs can take more space than the plain bits, keep such fonts uncompressed
+    if rle:
+        plain_size = sum(len(pack(glyph.rows)) for glyph in glyphs.values())
+        rle = sum(len(pack_rle(glyph.rows)) for glyph in glyphs.values()) < plain_size
+
+    bitmap = []
+    entries = []
+    for code, glyph in sorted(glyphs.items()):
+        entries.append(
+            f"    {{.bitmap_index = {len(bitmap)}, .code = 0x{code:02x}, .adv_w = {round(glyph.adv_w)}, "
+            f".box_w = {glyph.box_w}, .box_h = {glyph.box_h}, .ofs_x = {glyph.ofs_x}, .ofs_y = {glyph.ofs_y}}},"
+            f" /* {describe(code)} */")
+        bitmap += pack_rle(glyph.rows) if rle else pack(glyph.rows)
+
+    lines = [f"// {size} px, {len(glyphs)} glyphs, {len(bitmap)} bitmap bytes{', RLE' if rle else ''}"]
+    lines += format_bitmap(f"{name}_bitmap", bitmap)
+    lines.append("")
+    lines.append(f"static const bitmap_glyph_t {name}_glyphs[] = {{")
+    lines += entries
+    lines.append("};")
+    lines.append("")
+    lines.append(f"static const bitmap_font_t {name} = {{")
+    lines.append(f"    .bitmap = {name}_bitmap,")
+    lines.append(f"    .glyphs = {name}_glyphs,")
+    lines.append(f"    .glyph_count = ARRAY_SIZE({name}_glyphs),")
+    lines.append(f"    .line_height = {line_height},")
+    lines.append(f"    .base_line = {base_line},")
+    lines.append(f"    .compressed = {'true' if rle else 'false'},")
+    lines.append("};")
+    return "\n".join(lines), len(bitmap)
+
+
+def format_lvgl(name, size, glyphs, line_height, base_line):
+    codes = sorted(glyphs)
+    bitmap = []
+    entries = ["    {.bitmap_index = 0, .adv_w = 0, .box_w = 0, .box_h = 0, .ofs_x = 0, .ofs_y = 0} /* id = 0 reserved */,"]
+    for code in codes:
+        glyph = glyphs[code]
+        entries.append(
+            f"    {{.bitmap_index = {len(bitmap)}, .adv_w = {round(glyph.adv_w * 16)}, .box_w = {glyph.box_w}, "
+            f".box_h = {glyph.box_h}, .ofs_x = {glyph.ofs_x}, .ofs_y = {glyph.ofs_y}}}, /* {describe(code)} */")
+        bitmap += pack(glyph.rows)
+    # LVGL reads the bitmap of an empty glyph, keep the index valid
+    bitmap = bitmap or [0]
+
+    lines = [f"// {size} px, {len(glyphs)} glyphs, {len(bitmap)} bitmap bytes"]
+    lines += format_bitmap(f"{name}_bitmap", bitmap, "static LV_ATTRIBUTE_LARGE_CONST const")
+    lines.append("")
+    lines.append(f"static const lv_font_fmt_txt_glyph_dsc_t {name}_glyph_dsc[] = {{")
+    lines += entries
+    lines.append("};")
+    lines.append("")
+    lines.append(f"static const uint16_t {name}_unicode_list[] = {{")
+    for i in range(0, len(codes), 12):
+        lines.append("    " + ", ".join(f"0x{code - codes[0]:x}" for code in codes[i:i + 12]) + ",")
+    lines.append("};")
+    lines.append("")
+    lines.append(f"static const lv_font_fmt_txt_cmap_t {name}_cmaps[] = {{")
+    lines.append(f"    {{.range_start = {codes[0]}, .range_length = {codes[-1] - codes[0] + 1}, .glyph_id_start = 1, "
+                 f".unicode_list = {name}_unicode_list, .glyph_id_ofs_list = NULL, .list_length = {len(codes)}, "
+                 f".type = LV_FONT_FMT_TXT_CMAP_SPARSE_TINY}},")
+    lines.append("};")
+    lines.append("")
+    lines.append("#if LVGL_VERSION_MAJOR == 8")
+    lines.append(f"static lv_font_fmt_txt_glyph_cache_t {name}_cache;")
+    lines.append("#endif")
+    lines.append("")
+    lines.append(f"static const lv_font_fmt_txt_dsc_t {name}_dsc = {{")
+    lines.append(f"    .glyph_bitmap = {name}_bitmap,")
+    lines.append(f"    .glyph_dsc = {name}_glyph_dsc,")
+    lines.append(f"    .cmaps = {name}_cmaps,")
+    lines.append("    .kern_dsc = NULL,")
+    lines.append("    .kern_scale = 0,")
+    lines.append("    .cmap_num = 1,")
+    lines.append("    .bpp = 1,")
+    lines.append("    .kern_classes = 0,")
+    lines.append("    .bitmap_format = 0,")
+    lines.append("#if LVGL_VERSION_MAJOR == 8")
+    lines.append(f"    .cache = &{name}_cache,")
+    lines.append("#endif")
+    lines.append("};")
+    lines.append("")
+    lines.append(f"const lv_font_t {name} = {{")
+    lines.append("    .get_glyph_dsc = lv_font_get_glyph_dsc_fmt_txt,")
+    lines.append("    .get_glyph_bitmap = lv_font_get_bitmap_fmt_txt,")
+    lines.append(f"    .line_height = {line_height},")
+    lines.append(f"    .base_line = {base_line},")
+    lines.append("    .subpx = LV_FONT_SUBPX_NONE,")
+    lines.append(f"    .dsc = &{name}_dsc,")
+    lines.append("};")
+    return "\n".join(lines), len(bitmap)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", help="1-bpp lv_font_conv C font")
+    parser.add_argument("output", help="Generated header or source")
+    parser.add_argument("--format", choices=["direct", "lvgl"], default="direct")
+    parser.add_argument("--rle", action="store_true", help="RLE compress the glyphs of direct fonts")
+    parser.add_argument("--font", action="append", required=True, metavar="NAME:SIZE[:CHARS]",
+                        help="Font to generate, can be given multiple times")
+    parser.add_argument("--chars", action="append", default=[], metavar="NAME=CHARS",
+                        help="Characters to include in a font")
+    parser.add_argument("--chars-from", action="append", default=[], metavar="NAME=FILE:FUNCTION[,FUNCTION]",
+                        help="Include the characters of the string literals of C functions in a font")
+    args = parser.parse_args()
+
+    source = parse_source(args.source)
+
+    fonts = {}
+    for spec in args.font:
+        name, size, *chars = spec.split(":", 2)
+        fonts[name] = (int(size), "".join(chars).encode("latin-1").decode("unicode_escape"))
+    for spec in args.chars:
+        name, chars = spec.split("=", 1)
+        fonts[name] = (fonts[name][0], fonts[name][1] + chars.encode("latin-1").decode("unicode_escape"))
+    for spec in args.chars_from:
+        name, location = spec.split("=", 1)
+        path, functions = location.rsplit(":", 1)
+        for function in functions.split(","):
+            fonts[name] = (fonts[name][0], fonts[name][1] + string_literals(path, function))
+
+    generated = []
+    for name, (size, chars) in fonts.items():
+        glyphs, line_height, base_line = build_font(size, source, chars)
+        if args.format == "direct":
+            text, bitmap_size = format_direct(name, size, glyphs, line_height, base_line, args.rle)
+        else:
+            text, bitmap_size = format_lvgl(name, size, glyphs, line_height, base_line)
+        generated.append(text)
+        print(f"{name}: {size} px, {len(glyphs)} glyphs \"{''.join(chr(c) for c in sorted(glyphs))}\", "
+              f"{bitmap_size} bitmap bytes")
+
+    source_name = args.source.split("/")[-1]
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write(f"// Generated by scripts/font_converter.py from {source_name}, do not edit\n")
+        if args.format == "direct":
+            guard = re.sub(r"\W", "_", args.output.split("/")[-1]).upper()
+            f.write(f"#ifndef {guard}\n#define {guard}\n\n")
+            f.write("#include <utils/bitmap_font.h>\n\n#include <zephyr/sys/util.h>\n\n")
+            f.write("\n\n".join(generated))
+            f.write(f"\n\n#endif // {guard}\n")
+        else:
+            f.write("#include <lvgl.h>\n\n")
+            f.write("\n\n".join(generated))
+            f.write("\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -7,6 +7,8 @@
 #include <components/event_handler.h>
 #include <components/state_manager.h>
 #include <components/flash_manager.h>
+#include <components/sleep_policy.h>
+#include <utils/retained_state.h>
 
 #include <zephyr/logging/log.h>
 
@@ -42,6 +44,12 @@ static struct k_sem advertising_sem;
  */
 static struct k_work_delayable periodic_work;
 
+/**
+ * @brief Measurement cycles since the last cold boot, continues after a warm boot with retained state
+ *
+ */
+static uint32_t measurement_epoch;
+
 /**
  * @brief Update data to BLE service and start data advertisement
  *
@@ -50,6 +58,15 @@ static struct k_work_delayable periodic_work;
 static int advertise_data(void)
 {
     int rc = 0;
+
+    // Enable the controller again if it was disabled for the idle gap
+    rc = resume_ble();
+    if (rc != 0)
+    {
+        LOG_ERR("Error resuming BLE (err %d).", rc);
+        return rc;
+    }
+
     // Update and advertise data
     LOG_INF("Update advertised data.");
     update_advertisement_data();
@@ -99,6 +116,24 @@ static int64_t calculate_task_delay(int64_t start_time_ms)
     return delay;
 }
 
+/**
+ * @brief Count a finished measurement cycle
+ *
+ * @return uint8_t Number of the measurement within the current advertisement interval, starting from 1
+ */
+static uint8_t count_measurement(void)
+{
+    measurement_epoch++;
+#ifdef CONFIG_RETAINED_STATE
+    // One lock and one CRC update for the whole cycle
+    retained_state_t *retained = lock_retained_state();
+    retained->epoch = measurement_epoch;
+    save_buffers(retained->buffers, retained->buffer_index);
+    unlock_retained_state();
+#endif
+    return (measurement_epoch - 1) % CONFIG_MEASUREMENTS_PER_INTERVAL + 1;
+}
+
 /**
  * @brief Periodic task that takes care of reading sensor data and advertising it over BLE
  *
@@ -106,7 +141,7 @@ static int64_t calculate_task_delay(int64_t start_time_ms)
  */
 static void periodic_task(struct k_work *work)
 {
-    static uint8_t measurement_counter = 0;
+    static bool first_task = true;
     bool success = true;
     int rc = 0;
 
@@ -114,12 +149,17 @@ static void periodic_task(struct k_work *work)
 
     // Log time for calculating correct time to sleep
     int64_t start_time_ms = k_uptime_get();
+    if (first_task)
+    {
+        LOG_INF("First measurement %lld ms after boot.", start_time_ms);
+#ifdef CONFIG_RETAINED_STATE
+        record_boot_to_ready(start_time_ms);
+#endif
+        first_task = false;
+    }
 
-    // Set state to measuring and idle idle some time for sensor warmup
+    // Set state to measuring, the sensors are warmed up and read one by one in read_sensors
     set_state(MEASURING);
-    LOG_INF("Sensor warming up started, waiting for %d ms.", CONFIG_SENSOR_WARMUP_TIME_MS);
-    k_sleep(K_MSEC(CONFIG_SENSOR_WARMUP_TIME_MS));
-    LOG_INF("Sensor warm up complete.");
 
 #ifdef CONFIG_ENABLE_BATTERY_MONITOR
     LOG_INF("Reading battery level.");
@@ -130,6 +170,9 @@ static void periodic_task(struct k_work *work)
         success = false;
         dispatch_event(PERIODIC_TASK_WARNING);
     }
+#else
+    // No battery reading, shown as not available instead of a level the display policy would take for a low battery
+    set_value(BATTERY_LEVEL, -1.0f);
 #endif
 
     LOG_INF("Reading sensors.");
@@ -141,15 +184,12 @@ static void periodic_task(struct k_work *work)
         dispatch_event(PERIODIC_TASK_WARNING);
     }
 
-    // Increment measurement counter and print progress in log
-    measurement_counter++;
+    // Count the measurement and print progress in log
+    uint8_t measurement_counter = count_measurement();
     LOG_INF("Periodic measurement %d/%d done.", measurement_counter, CONFIG_MEASUREMENTS_PER_INTERVAL);
 
 #ifdef CONFIG_ENABLE_EPD
-
-    // Set state to displaying
-    set_state(UPDATING);
-
+    // Only hands the values over, the display refreshes in parallel with the rest of the cycle
     LOG_INF("Updating displayed values.");
     rc = update_e_paper_display();
     if (rc != 0)
@@ -178,12 +218,15 @@ static void periodic_task(struct k_work *work)
 
         // Enter idle state
         set_state(IDLE);
+        rc = enter_sleep(delay);
+        if (rc != 0)
+        {
+            LOG_WRN("Failed to enter sleep (err %d).", rc);
+            dispatch_event(PERIODIC_TASK_WARNING);
+        }
         return;
     }
 
-    // Reset measurement counter
-    measurement_counter = 0;
-
     // Set state to advertising
     set_state(ADVERTISING);
 
@@ -216,6 +259,12 @@ static void periodic_task(struct k_work *work)
 
     LOG_INF("Task scheduled, going idle.");
     set_state(IDLE);
+    rc = enter_sleep(delay);
+    if (rc != 0)
+    {
+        LOG_WRN("Failed to enter sleep (err %d).", rc);
+        dispatch_event(PERIODIC_TASK_WARNING);
+    }
 }
 
 /**
@@ -341,7 +390,11 @@ int init_air_quality_monitor(void)
     register_ble_connect_cb(ble_connected_callback);
     register_pairing_result_cb(pairing_result_callback);
     register_pairing_complete_cb(pairing_task_callback);
+#ifdef CONFIG_BT
     LOG_INF("BLE initialized succesfully. BLE device \"%s\" online.", CONFIG_BT_DEVICE_NAME);
+#else
+    LOG_INF("Simulated BLE initialized succesfully.");
+#endif
 
     // Initialize sensors
     LOG_INF("Initializing the sensors.");
@@ -387,16 +440,15 @@ int init_air_quality_monitor(void)
     return 0;
 }
 
-int start_air_quality_monitor(void)
+/**
+ * @brief Open the pairing window and wait for it to complete
+ *
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int run_pairing_window(void)
 {
     int rc = 0;
 
-    // Enter idle state
-    set_state(STARTUP);
-
-    // Initialize pairing and advertisement semaphores
-    k_sem_init(&pairing_sem, 0, 1);
-
     // Start pairing mode
     LOG_INF("Starting pairing, waiting for %d ms.", CONFIG_PAIRING_TIMEOUT);
     display_notification("Pairing");
@@ -405,8 +457,6 @@ int start_air_quality_monitor(void)
     if (rc != 0)
     {
         LOG_ERR("Error while starting pairing mode (err %d).", rc);
-        dispatch_event(STARTUP_ERROR);
-        set_state(ERROR);
         return rc;
     }
 
@@ -415,11 +465,44 @@ int start_air_quality_monitor(void)
     if (rc != 0)
     {
         LOG_ERR("Pairing semaphore timeout (err %d).", rc);
-        dispatch_event(STARTUP_ERROR);
-        set_state(ERROR);
         return rc;
     }
     display_notification("");
+    return 0;
+}
+
+int start_air_quality_monitor(void)
+{
+    int rc = 0;
+
+    // Enter idle state
+    set_state(STARTUP);
+
+    // Initialize pairing and advertisement semaphores
+    k_sem_init(&pairing_sem, 0, 1);
+
+#ifdef CONFIG_RETAINED_STATE
+    // After a warm boot the device was already set up, resume measuring without the pairing window
+    measurement_epoch = get_retained_state()->epoch;
+    bool resume = retained_state_is_warm() && has_bonded_devices();
+#else
+    bool resume = false;
+#endif
+    if (resume)
+    {
+        LOG_INF("Warm boot %u, resuming at measurement cycle %u.", get_retained_state()->boot_count,
+                measurement_epoch);
+    }
+    else
+    {
+        rc = run_pairing_window();
+        if (rc != 0)
+        {
+            dispatch_event(STARTUP_ERROR);
+            set_state(ERROR);
+            return rc;
+        }
+    }
 
     if (!has_bonded_devices())
     {
@@ -443,10 +526,13 @@ int start_air_quality_monitor(void)
                        PERIODIC_TASK_THREAD_STACK_SIZE, PERIODIC_TASK_THREAD_PRIORITY, NULL);
     k_sem_init(&advertising_sem, 0, 1);
 
-    // Initialize periodic task and time the first task in 10 seconds
+    // Initialize periodic task and time the first task in 10 seconds, right away when resuming after a warm boot
     LOG_INF("Setting up the periodic task for measuring and advertising data.");
     k_work_init_delayable(&periodic_work, periodic_task);
-    rc = schedule_work_task(10000); // Start the first task in 10 seconds, some fuckery with timing and priorities here...
+
+    // Enter idle state before scheduling, an immediate first task sets its own state
+    set_state(IDLE);
+    rc = schedule_work_task(resume ? 0 : 10000); // Some fuckery with timing and priorities here...
     if (rc != 0)
     {
         dispatch_event(STARTUP_ERROR);
@@ -456,8 +542,5 @@ int start_air_quality_monitor(void)
     LOG_INF("Periodic task started succesfully.");
     dispatch_event(STARTUP_SUCCESS);
 
-    // Enter idle state
-    set_state(IDLE);
-
     return 0;
 }
\ No newline at end of file
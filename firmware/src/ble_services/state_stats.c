@@ -0,0 +1,78 @@
+#include <components/state_manager.h>
+
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/sys/byteorder.h>
+
+#ifdef CONFIG_STATE_STATS
+
+// States reported over BLE, the ones the device spends its life in
+static const state_t reported_states[] = {MEASURING, UPDATING, ADVERTISING, IDLE, SAMPLING};
+
+// Per state record: state (u8), entries (u32), total s (u32), mean ms (u32), max ms (u32), charge uAh (u32)
+#define STATE_RECORD_SIZE (1 + 5 * sizeof(uint32_t))
+
+// Daily charge estimate in uAh (u32) followed by the state records, little endian
+#define STATE_STATS_SIZE (sizeof(uint32_t) + ARRAY_SIZE(reported_states) * STATE_RECORD_SIZE)
+
+// Snapshot of the value per connection, a long read spans several requests that must see the same statistics
+static uint8_t snapshots[CONFIG_BT_MAX_CONN][STATE_STATS_SIZE];
+
+/** @brief Gather the state statistics into a value
+ *
+ *  @param value Value to fill, STATE_STATS_SIZE bytes.
+ */
+static void gather_state_stats(uint8_t *value)
+{
+    uint8_t *ptr = value;
+    state_stats_t stats;
+
+    sys_put_le32(get_daily_charge_uah(), ptr);
+    ptr += sizeof(uint32_t);
+    for (size_t i = 0; i < ARRAY_SIZE(reported_states); i++)
+    {
+        get_state_stats(reported_states[i], &stats);
+        *ptr++ = reported_states[i];
+        sys_put_le32(stats.entries, ptr);
+        sys_put_le32(stats.total_ms / 1000, ptr + 4);
+        sys_put_le32(stats.mean_ms, ptr + 8);
+        sys_put_le32(stats.max_ms, ptr + 12);
+        sys_put_le32(stats.charge_uah, ptr + 16);
+        ptr += 5 * sizeof(uint32_t);
+    }
+}
+
+/** @brief Read the state statistics, gathered when a read starts at offset 0 and served from that snapshot for the
+ *  following offsets.
+ *
+ *  @param conn Connection object.
+ *  @param attr Attribute to read.
+ *  @param buf Buffer to store the value.
+ *  @param len Buffer length.
+ *  @param offset Start offset.
+ *
+ *  @return number of bytes read in case of success or negative values in case of error.
+ */
+static ssize_t read_state_stats(struct bt_conn *conn,
+                                const struct bt_gatt_attr *attr, void *buf,
+                                uint16_t len, uint16_t offset)
+{
+    uint8_t *value = snapshots[bt_conn_index(conn)];
+    if (offset == 0)
+    {
+        gather_state_stats(value);
+    }
+    return bt_gatt_attr_read(conn, attr, buf, len, offset, value, STATE_STATS_SIZE);
+}
+
+// Custom state statistics service and characteristic UUIDs
+#define BT_UUID_STATE_STATS_SERVICE_VAL BT_UUID_128_ENCODE(0x8caa4e2b, 0x31ef, 0x4e50, 0xa19d, 0xbdfd38918119)
+#define BT_UUID_STATE_STATS_SERVICE BT_UUID_DECLARE_128(BT_UUID_STATE_STATS_SERVICE_VAL)
+#define BT_UUID_STATE_STATS_VAL BT_UUID_128_ENCODE(0x8caa4e2c, 0x31ef, 0x4e50, 0xa19d, 0xbdfd38918119)
+#define BT_UUID_STATE_STATS BT_UUID_DECLARE_128(BT_UUID_STATE_STATS_VAL)
+
+// Create service
+BT_GATT_SERVICE_DEFINE(state_stats, BT_GATT_PRIMARY_SERVICE(BT_UUID_STATE_STATS_SERVICE),
+                       BT_GATT_CHARACTERISTIC(BT_UUID_STATE_STATS, BT_GATT_CHRC_READ, BT_GATT_PERM_READ_ENCRYPT, read_state_stats, NULL, NULL), );
+
+#endif // CONFIG_STATE_STATS
@@ -64,6 +64,12 @@ static struct k_work_delayable stop_ble_work;
  */
 static ble_state_t ble_state = BLE_STATE_NOT_SET;
 
+/**
+ * @brief True while the BLE controller is disabled between periodic tasks
+ *
+ */
+static bool ble_suspended = false;
+
 /**
  * @brief Stores the current connection information
  *
@@ -580,4 +586,62 @@ int start_advertise(void)
         return rc;
     }
     return 0;
-}
\ No newline at end of file
+}
+
+int suspend_ble(void)
+{
+    int rc = 0;
+    if (ble_suspended)
+    {
+        return 0;
+    }
+
+    // The disconnection of the last central may still be in progress
+    if (current_conn || get_ble_state() == BLE_PAIRING)
+    {
+        return -EBUSY;
+    }
+
+    rc = bt_disable();
+    if (rc != 0)
+    {
+        LOG_ERR("BLE disable failed (err %d).", rc);
+        return rc;
+    }
+    ble_suspended = true;
+    set_ble_state(BLE_STATE_NOT_SET);
+    LOG_INF("BLE controller disabled.");
+    return 0;
+}
+
+int resume_ble(void)
+{
+    int rc = 0;
+    if (!ble_suspended)
+    {
+        return 0;
+    }
+
+    rc = bt_enable(NULL);
+    if (rc != 0)
+    {
+        LOG_ERR("BLE enable failed (err %d).", rc);
+        return rc;
+    }
+
+    // The identity and the bonds have to be loaded again, the connection callbacks stay registered
+    rc = settings_load_subtree("bt");
+    if (rc != 0)
+    {
+        LOG_ERR("Loading BLE settings failed (err %d).", rc);
+        return rc;
+    }
+
+    // The controller lost the filter accept list
+    populate_bonded_filter_list();
+
+    ble_suspended = false;
+    set_ble_state(BLE_IDLE);
+    LOG_INF("BLE controller enabled.");
+    return 0;
+}
@@ -0,0 +1,161 @@
+#include <components/display_policy.h>
+
+#include <zephyr/kernel.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+LOG_MODULE_REGISTER(display_policy);
+
+#ifdef CONFIG_DISPLAY_POLICY
+static display_policy_config_t policy_config = {
+    .low_battery_level = CONFIG_DISPLAY_POLICY_LOW_BATTERY_LEVEL,
+    .stable_period_s = CONFIG_DISPLAY_POLICY_STABLE_PERIOD_S,
+    .active_interval_s = CONFIG_DISPLAY_POLICY_ACTIVE_INTERVAL_S,
+    .stable_interval_s = CONFIG_DISPLAY_POLICY_STABLE_INTERVAL_S,
+    .low_battery_interval_s = CONFIG_DISPLAY_POLICY_LOW_BATTERY_INTERVAL_S,
+    .low_battery_damage_threshold = CONFIG_DISPLAY_POLICY_LOW_BATTERY_DAMAGE_THRESHOLD,
+};
+#else
+static display_policy_config_t policy_config;
+#endif
+
+// The settings are changed from the shell and read from the display work queue
+K_MUTEX_DEFINE(policy_mutex);
+
+static display_mode_t current_mode = DISPLAY_MODE_ACTIVE;
+
+display_plan_t select_display_plan(float battery_level, int64_t stable_ms)
+{
+    // Without the policy every change is refreshed right away
+    display_plan_t plan = {
+        .mode = DISPLAY_MODE_ACTIVE,
+        .face = DISPLAY_FACE_DASHBOARD,
+        .min_interval_s = 0,
+        .damage_threshold = CONFIG_EPD_DAMAGE_THRESHOLD,
+        .opportunistic_full = true,
+    };
+
+#ifdef CONFIG_DISPLAY_POLICY
+    display_policy_config_t config;
+    get_display_policy_config(&config);
+    plan.min_interval_s = config.active_interval_s;
+
+    if (battery_level != -1 && battery_level <= config.low_battery_level)
+    {
+        // Fewer and smaller partial updates, and ghosting is tolerated longer instead of spending full refreshes
+        plan.mode = DISPLAY_MODE_LOW_BATTERY;
+        plan.face = DISPLAY_FACE_CO2;
+        plan.min_interval_s = config.low_battery_interval_s;
+        plan.damage_threshold = config.low_battery_damage_threshold;
+        plan.opportunistic_full = false;
+    }
+    else if (stable_ms >= (int64_t)config.stable_period_s * MSEC_PER_SEC)
+    {
+        // Nothing to follow closely, chart columns and stale values are batched
+        plan.mode = DISPLAY_MODE_STABLE;
+        plan.min_interval_s = config.stable_interval_s;
+    }
+#endif
+
+    if (plan.mode != current_mode)
+    {
+        LOG_INF("Display mode %s.", display_mode_to_string(plan.mode));
+        current_mode = plan.mode;
+    }
+    return plan;
+}
+
+void get_display_policy_config(display_policy_config_t *config)
+{
+    k_mutex_lock(&policy_mutex, K_FOREVER);
+    *config = policy_config;
+    k_mutex_unlock(&policy_mutex);
+}
+
+void set_display_policy_config(const display_policy_config_t *config)
+{
+    k_mutex_lock(&policy_mutex, K_FOREVER);
+    policy_config = *config;
+    k_mutex_unlock(&policy_mutex);
+}
+
+const char *display_mode_to_string(display_mode_t mode)
+{
+    switch (mode)
+    {
+    case DISPLAY_MODE_ACTIVE:
+        return "ACTIVE";
+    case DISPLAY_MODE_STABLE:
+        return "STABLE";
+    case DISPLAY_MODE_LOW_BATTERY:
+        return "LOW_BATTERY";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+#if defined(CONFIG_SHELL) && defined(CONFIG_DISPLAY_POLICY)
+/**
+ * @brief Shell command printing the display policy settings, or changing one of them
+ *
+ * @param sh Shell instance
+ * @param argc Number of arguments
+ * @param argv Arguments, optionally a setting name and its new value
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int cmd_display_policy(const struct shell *sh, size_t argc, char **argv)
+{
+    display_policy_config_t config;
+    get_display_policy_config(&config);
+
+    struct
+    {
+        const char *name;
+        uint32_t *value;
+    } settings[] = {
+        {"low_battery_level", &config.low_battery_level},
+        {"stable_period_s", &config.stable_period_s},
+        {"active_interval_s", &config.active_interval_s},
+        {"stable_interval_s", &config.stable_interval_s},
+        {"low_battery_interval_s", &config.low_battery_interval_s},
+        {"low_battery_damage_threshold", &config.low_battery_damage_threshold},
+    };
+
+    if (argc == 3)
+    {
+        size_t i = 0;
+        while (i < ARRAY_SIZE(settings) && strcmp(argv[1], settings[i].name) != 0)
+        {
+            i++;
+        }
+        char *end;
+        unsigned long value = strtoul(argv[2], &end, 10);
+        if (i == ARRAY_SIZE(settings) || *end != '\0')
+        {
+            shell_error(sh, "Usage: display_policy [<setting> <value>]");
+            return -EINVAL;
+        }
+        *settings[i].value = value;
+        set_display_policy_config(&config);
+    }
+    else if (argc != 1)
+    {
+        shell_error(sh, "Usage: display_policy [<setting> <value>]");
+        return -EINVAL;
+    }
+
+    for (size_t i = 0; i < ARRAY_SIZE(settings); i++)
+    {
+        shell_print(sh, "%-28s %u", settings[i].name, *settings[i].value);
+    }
+    shell_print(sh, "Current mode %s.", display_mode_to_string(current_mode));
+    return 0;
+}
+
+SHELL_CMD_ARG_REGISTER(display_policy, NULL, "Print or change the display policy settings", cmd_display_policy, 1, 2);
+#endif // CONFIG_SHELL && CONFIG_DISPLAY_POLICY
@@ -0,0 +1,352 @@
+#include <components/display_renderer.h>
+#include <utils/bitmap_font.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+
+#ifdef CONFIG_DISPLAY_RENDERER_DIRECT
+
+// Generated at build time, see CMakeLists.txt
+#include <bitmap_fonts.h>
+
+LOG_MODULE_REGISTER(display_renderer_direct);
+
+// The panel is used rotated by 90 degrees like with LVGL, screen x runs from the panel bottom to top and screen y
+// from the panel left to right
+#define PANEL_NODE DT_ALIAS(ssd1680)
+#define PANEL_WIDTH DT_PROP(PANEL_NODE, width)
+#define PANEL_HEIGHT DT_PROP(PANEL_NODE, height)
+#define PANEL_PAGES (PANEL_HEIGHT / 8)
+#define SCREEN_WIDTH PANEL_HEIGHT
+#define SCREEN_HEIGHT PANEL_WIDTH
+
+// Small changed areas are copied here and written on their own instead of as full width pages
+#define RECT_BUFFER_SIZE 512
+
+BUILD_ASSERT(PANEL_HEIGHT % 8 == 0, "Panel height must be a multiple of 8 rows");
+
+typedef struct
+{
+    int16_t x1;
+    int16_t y1;
+    int16_t x2; // Exclusive
+    int16_t y2; // Exclusive
+} area_t;
+
+typedef struct
+{
+    const char *text; // Owned by the caller, see renderer_set_text
+    area_t drawn; // Pixels covered by the drawn text, cleared before it is redrawn
+    bool dirty;
+} field_t;
+
+typedef struct
+{
+    uint8_t levels[RENDERER_CHART_MAX_WIDTH]; // Bar heights, oldest column first
+    uint8_t drawn[RENDERER_CHART_MAX_WIDTH];  // Bar heights in the framebuffer
+    bool visible;
+} chart_t;
+
+// Framebuffer in the panel layout, vertically tiled: a byte holds 8 rows of one column, a page is 8 rows
+static uint8_t framebuffer[PANEL_PAGES * PANEL_WIDTH];
+static uint8_t rect_buffer[RECT_BUFFER_SIZE];
+static field_t fields[NUM_DISPLAY_FIELDS];
+static const field_layout_t *field_layout;
+static chart_t charts[NUM_DISPLAY_CHARTS];
+static const chart_layout_t *chart_layouts;
+static const struct device *display;
+
+static bool msb_first; // Topmost row of a page in the most significant bit
+static bool ink_set;   // Black pixels are set bits
+
+// Pages and panel columns changed since the last flush, first > last if none
+static int dirty_first;
+static int dirty_last;
+static int dirty_left;
+static int dirty_right;
+
+static const bitmap_font_t *get_font(uint8_t font_size)
+{
+    switch (font_size)
+    {
+    case 16:
+        return &display_font_16;
+    case 24:
+        return &display_font_24;
+    default:
+        return &display_font_32;
+    }
+}
+
+static void set_pixel(int x, int y, bool black)
+{
+    if (x < 0 || x >= SCREEN_WIDTH || y < 0 || y >= SCREEN_HEIGHT)
+    {
+        return;
+    }
+
+    int panel_x = y;
+    int panel_y = SCREEN_WIDTH - 1 - x;
+    int page = panel_y / 8;
+    uint8_t mask = msb_first ? BIT(7 - panel_y % 8) : BIT(panel_y % 8);
+    uint8_t *byte = &framebuffer[page * PANEL_WIDTH + panel_x];
+    if (black == ink_set)
+    {
+        *byte |= mask;
+    }
+    else
+    {
+        *byte &= ~mask;
+    }
+
+    dirty_first = MIN(dirty_first, page);
+    dirty_last = MAX(dirty_last, page);
+    dirty_left = MIN(dirty_left, panel_x);
+    dirty_right = MAX(dirty_right, panel_x);
+}
+
+static void clear_area(const area_t *area)
+{
+    for (int y = area->y1; y < area->y2; y++)
+    {
+        for (int x = area->x1; x < area->x2; x++)
+        {
+            set_pixel(x, y, false);
+        }
+    }
+}
+
+/**
+ * @brief Clear the previous text of a field and draw the current one
+ *
+ * @param field Field to draw
+ */
+static void draw_field(display_field_t field)
+{
+    field_t *state = &fields[field];
+    const field_layout_t *layout = &field_layout[field];
+    const bitmap_font_t *font = get_font(layout->font_size);
+
+    clear_area(&state->drawn);
+
+    // Place the text box like LVGL aligns a label of the same size
+    int width = bitmap_font_text_width(font, state->text);
+    int height = font->line_height;
+    int x = layout->x;
+    int y = layout->y;
+    switch (layout->align)
+    {
+    case FIELD_ALIGN_TOP_LEFT:
+        break;
+    case FIELD_ALIGN_TOP_RIGHT:
+        x += SCREEN_WIDTH - width;
+        break;
+    default:
+        x += (SCREEN_WIDTH - width) / 2;
+        y += (SCREEN_HEIGHT - height) / 2;
+        break;
+    }
+
+    area_t drawn = {.x1 = x, .y1 = y, .x2 = x, .y2 = y};
+    int baseline = y + height - font->base_line;
+    int pen = x;
+    for (const char *c = state->text; *c != '\0'; c++)
+    {
+        const bitmap_glyph_t *glyph = bitmap_font_find_glyph(font, (uint8_t)*c);
+        if (glyph == NULL)
+        {
+            continue;
+        }
+
+        int left = pen + glyph->ofs_x;
+        int top = baseline - glyph->ofs_y - glyph->box_h;
+        bitmap_glyph_reader_t reader;
+        bitmap_glyph_reader_init(&reader, font, glyph);
+        for (int row = 0; row < glyph->box_h; row++)
+        {
+            const uint8_t *bits = bitmap_glyph_read_row(&reader);
+            for (int col = 0; col < glyph->box_w; col++)
+            {
+                if (bits[col / 8] & (0x80 >> (col % 8)))
+                {
+                    set_pixel(left + col, top + row, true);
+                }
+            }
+        }
+
+        drawn.x1 = MIN(drawn.x1, left);
+        drawn.y1 = MIN(drawn.y1, top);
+        drawn.x2 = MAX(drawn.x2, left + glyph->box_w);
+        drawn.y2 = MAX(drawn.y2, top + glyph->box_h);
+        pen += glyph->adv_w;
+    }
+
+    state->drawn = drawn;
+    state->dirty = false;
+}
+
+/**
+ * @brief Redraw the columns of a chart whose bar height changed, after a shift only the columns next to a change in
+ * height differ
+ *
+ * @param chart Chart to draw
+ */
+static void draw_chart(display_chart_t chart)
+{
+    chart_t *state = &charts[chart];
+    const chart_layout_t *layout = &chart_layouts[chart];
+
+    for (int col = 0; col < layout->width; col++)
+    {
+        uint8_t level = state->visible ? state->levels[col] : 0;
+        if (level == state->drawn[col])
+        {
+            continue;
+        }
+
+        int bottom = layout->y + layout->height - 1;
+        for (int row = MIN(level, state->drawn[col]); row < MAX(level, state->drawn[col]); row++)
+        {
+            set_pixel(layout->x + col, bottom - row, row < level);
+        }
+        state->drawn[col] = level;
+    }
+}
+
+int renderer_init(const struct device *display_dev, const field_layout_t *layout, const chart_layout_t *chart_layout)
+{
+    struct display_capabilities caps;
+    display_get_capabilities(display_dev, &caps);
+    if (caps.x_resolution != PANEL_WIDTH || caps.y_resolution != PANEL_HEIGHT)
+    {
+        LOG_ERR("Display resolution %ux%u does not match the panel.", caps.x_resolution, caps.y_resolution);
+        return -EINVAL;
+    }
+    if (!(caps.screen_info & SCREEN_INFO_MONO_VTILED))
+    {
+        LOG_ERR("Display is not vertically tiled.");
+        return -ENOTSUP;
+    }
+
+    for (int i = 0; i < NUM_DISPLAY_CHARTS; i++)
+    {
+        if (chart_layout[i].width > RENDERER_CHART_MAX_WIDTH)
+        {
+            LOG_ERR("Chart %d is wider than %d columns.", i, RENDERER_CHART_MAX_WIDTH);
+            return -EINVAL;
+        }
+    }
+
+    display = display_dev;
+    field_layout = layout;
+    chart_layouts = chart_layout;
+    msb_first = caps.screen_info & SCREEN_INFO_MONO_MSB_FIRST;
+    ink_set = caps.current_pixel_format == PIXEL_FORMAT_MONO10;
+
+    // Start from a white screen, written completely on the first flush
+    memset(framebuffer, ink_set ? 0x00 : 0xFF, sizeof(framebuffer));
+    memset(fields, 0, sizeof(fields));
+    for (int i = 0; i < NUM_DISPLAY_FIELDS; i++)
+    {
+        fields[i].text = "";
+    }
+    memset(charts, 0, sizeof(charts));
+    dirty_first = 0;
+    dirty_last = PANEL_PAGES - 1;
+    dirty_left = 0;
+    dirty_right = PANEL_WIDTH - 1;
+
+    LOG_INF("Direct renderer using a %zu byte framebuffer.", sizeof(framebuffer));
+    return 0;
+}
+
+const char *renderer_get_text(display_field_t field)
+{
+    return fields[field].text;
+}
+
+void renderer_set_text(display_field_t field, const char *text)
+{
+    fields[field].text = text;
+    fields[field].dirty = true;
+}
+
+void renderer_push_chart(display_chart_t chart, uint8_t level)
+{
+    chart_t *state = &charts[chart];
+    int width = chart_layouts[chart].width;
+    memmove(state->levels, state->levels + 1, width - 1);
+    state->levels[width - 1] = MIN(level, chart_layouts[chart].height);
+}
+
+void renderer_show_chart(display_chart_t chart, bool visible)
+{
+    charts[chart].visible = visible;
+}
+
+int renderer_flush(void)
+{
+    for (int i = 0; i < NUM_DISPLAY_FIELDS; i++)
+    {
+        if (fields[i].dirty)
+        {
+            draw_field(i);
+        }
+    }
+    for (int i = 0; i < NUM_DISPLAY_CHARTS; i++)
+    {
+        draw_chart(i);
+    }
+
+    if (dirty_first > dirty_last)
+    {
+        return 0;
+    }
+
+    // Changed pages over the full panel width are contiguous in the framebuffer, a small changed area like a chart
+    // is gathered into the rect buffer so only that strip is written
+    int x = 0;
+    int pages = dirty_last - dirty_first + 1;
+    int width = dirty_right - dirty_left + 1;
+    const uint8_t *buf = &framebuffer[dirty_first * PANEL_WIDTH];
+    if (width < PANEL_WIDTH && pages * width <= RECT_BUFFER_SIZE)
+    {
+        for (int page = 0; page < pages; page++)
+        {
+            memcpy(&rect_buffer[page * width], &framebuffer[(dirty_first + page) * PANEL_WIDTH + dirty_left], width);
+        }
+        x = dirty_left;
+        buf = rect_buffer;
+    }
+    else
+    {
+        width = PANEL_WIDTH;
+    }
+
+    struct display_buffer_descriptor desc = {
+        .buf_size = pages * width,
+        .width = width,
+        .height = pages * 8,
+        .pitch = width,
+    };
+    int rc = display_write(display, x, dirty_first * 8, &desc, buf);
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to write to display (err %d).", rc);
+        return rc;
+    }
+    LOG_DBG("Wrote pages %d-%d, columns %d-%d, %u bytes.", dirty_first, dirty_last, x, x + width - 1, desc.buf_size);
+
+    dirty_first = PANEL_PAGES;
+    dirty_last = -1;
+    dirty_left = PANEL_WIDTH;
+    dirty_right = -1;
+    return 0;
+}
+
+#endif // CONFIG_DISPLAY_RENDERER_DIRECT
@@ -0,0 +1,157 @@
+#include <components/display_renderer.h>
+
+#include <zephyr/kernel.h>
+
+#include <zephyr/logging/log.h>
+
+#ifdef CONFIG_DISPLAY_RENDERER_LVGL
+
+#include <lvgl.h>
+
+LOG_MODULE_REGISTER(display_renderer_lvgl);
+
+// Generated at build time with only the displayed characters, see CMakeLists.txt
+LV_FONT_DECLARE(display_font_16);
+LV_FONT_DECLARE(display_font_24);
+LV_FONT_DECLARE(display_font_32);
+
+static lv_obj_t *labels[NUM_DISPLAY_FIELDS];
+static lv_obj_t *charts[NUM_DISPLAY_CHARTS];
+static lv_chart_series_t *chart_series[NUM_DISPLAY_CHARTS];
+
+static const lv_font_t *get_font(uint8_t font_size)
+{
+    switch (font_size)
+    {
+    case 16:
+        return &display_font_16;
+    case 24:
+        return &display_font_24;
+    default:
+        return &display_font_32;
+    }
+}
+
+static lv_align_t get_align(field_align_t align)
+{
+    switch (align)
+    {
+    case FIELD_ALIGN_TOP_LEFT:
+        return LV_ALIGN_TOP_LEFT;
+    case FIELD_ALIGN_TOP_RIGHT:
+        return LV_ALIGN_TOP_RIGHT;
+    default:
+        return LV_ALIGN_CENTER;
+    }
+}
+
+/**
+ * @brief Create a borderless bar chart with one pixel wide bars, new values shift the older ones out
+ *
+ * @param chart Chart to create
+ * @param layout Area of the chart
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int create_chart(display_chart_t chart, const chart_layout_t *layout)
+{
+    lv_obj_t *obj = lv_chart_create(lv_scr_act());
+    if (obj == NULL)
+    {
+        LOG_ERR("Failed to create chart %d.", chart);
+        return -ENOMEM;
+    }
+    lv_obj_set_pos(obj, layout->x, layout->y);
+    lv_obj_set_size(obj, layout->width, layout->height);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_TRANSP, LV_PART_MAIN);
+    lv_obj_set_style_border_width(obj, 0, LV_PART_MAIN);
+    lv_obj_set_style_pad_all(obj, 0, LV_PART_MAIN);
+    lv_obj_set_style_pad_column(obj, 0, LV_PART_MAIN);
+    lv_obj_set_style_pad_column(obj, 0, LV_PART_ITEMS);
+    lv_obj_set_style_radius(obj, 0, LV_PART_ITEMS);
+    lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
+
+    lv_chart_set_type(obj, LV_CHART_TYPE_BAR);
+    lv_chart_set_div_line_count(obj, 0, 0);
+    lv_chart_set_point_count(obj, layout->width);
+    lv_chart_set_range(obj, LV_CHART_AXIS_PRIMARY_Y, 0, layout->height);
+    lv_chart_set_update_mode(obj, LV_CHART_UPDATE_MODE_SHIFT);
+
+    chart_series[chart] = lv_chart_add_series(obj, lv_color_black(), LV_CHART_AXIS_PRIMARY_Y);
+    if (chart_series[chart] == NULL)
+    {
+        LOG_ERR("Failed to add series to chart %d.", chart);
+        return -ENOMEM;
+    }
+    lv_chart_set_all_value(obj, chart_series[chart], LV_CHART_POINT_NONE);
+    charts[chart] = obj;
+    return 0;
+}
+
+int renderer_init(const struct device *display_dev, const field_layout_t *layout, const chart_layout_t *chart_layout)
+{
+    // Configure LVGL for rotated display
+    lv_disp_t *disp = lv_disp_get_default();
+    if (disp)
+    {
+        lv_disp_set_rotation(disp, LV_DISP_ROT_90);
+    }
+
+    for (int i = 0; i < NUM_DISPLAY_FIELDS; i++)
+    {
+        labels[i] = lv_label_create(lv_scr_act());
+        if (labels[i] == NULL)
+        {
+            LOG_ERR("Failed to create label %d.", i);
+            return -ENOMEM;
+        }
+        lv_obj_set_style_text_font(labels[i], get_font(layout[i].font_size), 0);
+        lv_obj_align(labels[i], get_align(layout[i].align), layout[i].x, layout[i].y);
+    }
+
+    for (int i = 0; i < NUM_DISPLAY_CHARTS; i++)
+    {
+        int rc = create_chart(i, &chart_layout[i]);
+        if (rc != 0)
+        {
+            return rc;
+        }
+    }
+    return 0;
+}
+
+const char *renderer_get_text(display_field_t field)
+{
+    return lv_label_get_text(labels[field]);
+}
+
+void renderer_set_text(display_field_t field, const char *text)
+{
+    // Static text, LVGL keeps the pointer instead of allocating a copy from its pool
+    lv_label_set_text_static(labels[field], text);
+}
+
+void renderer_push_chart(display_chart_t chart, uint8_t level)
+{
+    // Only the chart area is invalidated, so only that strip is redrawn and flushed
+    lv_chart_set_next_value(charts[chart], chart_series[chart], level > 0 ? level : LV_CHART_POINT_NONE);
+}
+
+void renderer_show_chart(display_chart_t chart, bool visible)
+{
+    if (visible)
+    {
+        lv_obj_clear_flag(charts[chart], LV_OBJ_FLAG_HIDDEN);
+    }
+    else
+    {
+        lv_obj_add_flag(charts[chart], LV_OBJ_FLAG_HIDDEN);
+    }
+}
+
+int renderer_flush(void)
+{
+    lv_task_handler();
+    return 0;
+}
+
+#endif // CONFIG_DISPLAY_RENDERER_LVGL
@@ -1,36 +1,147 @@
 #include <components/e_paper_display.h>
+#include <components/display_renderer.h>
+#include <components/display_policy.h>
+#include <components/power_manager.h>
+#include <components/event_handler.h>
+#include <components/state_manager.h>
 #include <utils/variable_buffer.h>
 #include <utils/air_quality_mapper.h>
+#include <utils/decimal_format.h>
 
 #include <zephyr/kernel.h>
 #include <zephyr/device.h>
 #include <zephyr/drivers/display.h>
 #include <zephyr/pm/pm.h>
 #include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+#include <math.h>
 #include <stdint.h>
-#include <lvgl.h>
+#include <stdio.h>
+#include <string.h>
 
 #include <zephyr/logging/log.h>
 
 LOG_MODULE_REGISTER(e_paper_display);
 
-LV_FONT_DECLARE(lv_font_montserrat_64);
+/**
+ * @brief Lower priority work queue for rendering and refreshing, the panel waveform runs in parallel with advertising
+ *
+ */
+#define DISPLAY_THREAD_STACK_SIZE 4096
+#define DISPLAY_THREAD_PRIORITY K_PRIO_PREEMPT(2)
+K_THREAD_STACK_DEFINE(display_stack, DISPLAY_THREAD_STACK_SIZE);
+static struct k_work_q display_work_q;
+static struct k_work display_work;
+
+/**
+ * @brief Copy of what to show, taken by the caller so the display thread never reads buffers being written
+ *
+ */
+typedef struct
+{
+    bool notification;
+    char message[32];
+    float temperature;
+    float humidity;
+    float co2;
+    float voc_index;
+    float battery_level;
+} display_snapshot_t;
+
+// Latest snapshot, a snapshot submitted while an older one is still pending replaces it
+static display_snapshot_t pending_snapshot;
+K_MUTEX_DEFINE(snapshot_mutex);
+
+static uint32_t display_refreshes = 0;
 
 static const struct device *epd_dev;
 
-static lv_obj_t *notif_label;
-static lv_obj_t *temp_tag_label;
-static lv_obj_t *temp_val_label;
-static lv_obj_t *hum_tag_label;
-static lv_obj_t *hum_val_label;
-static lv_obj_t *co2_tag_label;
-static lv_obj_t *co2_val_label;
-static lv_obj_t *voc_tag_label;
-static lv_obj_t *voc_val_label;
-static lv_obj_t *batt_tag_label;
-static lv_obj_t *batt_val_label;
+// Tags on the left, values below them on the right, the notification in the middle of the rotated screen
+static const field_layout_t layout[NUM_DISPLAY_FIELDS] = {
+    [FIELD_NOTIFICATION] = {.font_size = 24, .align = FIELD_ALIGN_CENTER, .x = 0, .y = 0},
+    [FIELD_TEMPERATURE_TAG] = {.font_size = 16, .align = FIELD_ALIGN_TOP_LEFT, .x = 10, .y = 0},
+    [FIELD_TEMPERATURE_VALUE] = {.font_size = 32, .align = FIELD_ALIGN_TOP_RIGHT, .x = -12, .y = 18},
+    [FIELD_HUMIDITY_TAG] = {.font_size = 16, .align = FIELD_ALIGN_TOP_LEFT, .x = 10, .y = 52},
+    [FIELD_HUMIDITY_VALUE] = {.font_size = 32, .align = FIELD_ALIGN_TOP_RIGHT, .x = -12, .y = 70},
+    [FIELD_CO2_TAG] = {.font_size = 16, .align = FIELD_ALIGN_TOP_LEFT, .x = 10, .y = 104},
+    [FIELD_CO2_VALUE] = {.font_size = 32, .align = FIELD_ALIGN_TOP_RIGHT, .x = -12, .y = 122},
+    [FIELD_VOC_TAG] = {.font_size = 16, .align = FIELD_ALIGN_TOP_LEFT, .x = 10, .y = 156},
+    [FIELD_VOC_VALUE] = {.font_size = 24, .align = FIELD_ALIGN_TOP_RIGHT, .x = -12, .y = 173},
+    [FIELD_BATTERY_TAG] = {.font_size = 16, .align = FIELD_ALIGN_TOP_LEFT, .x = 10, .y = 198},
+    [FIELD_BATTERY_VALUE] = {.font_size = 32, .align = FIELD_ALIGN_TOP_RIGHT, .x = -12, .y = 215},
+};
+
+// Bar charts left of the temperature and CO2 values, the bars stand on the baseline of the values
+static const chart_layout_t chart_layout[NUM_DISPLAY_CHARTS] = {
+    [CHART_TEMPERATURE] = {.x = 4, .y = 21, .width = 16, .height = 24},
+    [CHART_CO2] = {.x = 4, .y = 125, .width = 16, .height = 24},
+};
+
+#define TEXT_SLOT_SIZE 32
 
-static char label_buffer[32];
+/**
+ * @brief Text formatted for a field. The renderers keep a pointer to the shown text instead of a copy, so a new
+ * text is written into the other buffer and the shown one stays untouched.
+ *
+ */
+typedef struct
+{
+    char text[2][TEXT_SLOT_SIZE];
+    uint8_t shown; // Buffer holding the latest text
+    int32_t value; // Value the latest text was formatted from
+} text_slot_t;
+
+static text_slot_t notification_slot;
+static text_slot_t temp_slot = {.value = INT32_MIN};
+static text_slot_t hum_slot = {.value = INT32_MIN};
+static text_slot_t co2_slot = {.value = INT32_MIN};
+static text_slot_t batt_slot = {.value = INT32_MIN};
+
+static void display_task(struct k_work *work);
+
+// Value currently shown for a field, only replaced when the latest value leaves the deadband or goes stale
+typedef struct
+{
+    float shown; // -1 if nothing shown yet or no value
+    int64_t shown_ms;
+} field_hysteresis_t;
+
+static field_hysteresis_t temp_hysteresis = {.shown = -1};
+static field_hysteresis_t hum_hysteresis = {.shown = -1};
+static field_hysteresis_t co2_hysteresis = {.shown = -1};
+static field_hysteresis_t voc_hysteresis = {.shown = -1};
+static field_hysteresis_t batt_hysteresis = {.shown = -1};
+
+static uint32_t skipped_refreshes = 0;
+static uint64_t render_time_us = 0;
+
+// Ghosting damage accumulated by each field, followed by each chart, through partial updates since the last full
+// refresh
+static uint32_t region_damage[NUM_DISPLAY_FIELDS + NUM_DISPLAY_CHARTS];
+static int64_t last_refresh_ms;
+
+// Time of the last changed value, ends the stable mode of the display policy
+static int64_t last_value_change_ms;
+
+// Time a value last left its deadband, stale values and chart columns do not end a quiet period
+static int64_t last_deadband_exit_ms;
+
+// Changes already set on the renderer but held back by the refresh interval of the display policy
+static bool pending_changes = false;
+static uint32_t deferred_refreshes = 0;
+
+#ifdef CONFIG_DISPLAY_TREND
+// Sum of the samples averaged into the next column of a chart
+typedef struct
+{
+    float sum;
+    uint32_t count;
+} trend_column_t;
+
+static trend_column_t trend_columns[NUM_DISPLAY_CHARTS];
+static int64_t trend_column_start_ms;
+static bool charts_visible = false;
+#endif
 
 int init_e_paper_display(void)
 {
@@ -41,173 +152,578 @@ int init_e_paper_display(void)
         return -ENXIO;
     }
 
-    // Configure LVGL for rotated display
-    lv_disp_t *disp = lv_disp_get_default();
-    if (disp)
-    {
-        lv_disp_set_rotation(disp, LV_DISP_ROT_90);
-    }
-
-    // Setup notification label
-    notif_label = lv_label_create(lv_scr_act());
-    lv_obj_set_style_text_font(notif_label, &lv_font_montserrat_24, 0);
-    lv_obj_align(notif_label, LV_ALIGN_CENTER, 0, 0);
-
-    // Set up temperature labels
-    temp_tag_label = lv_label_create(lv_scr_act());
-    temp_val_label = lv_label_create(lv_scr_act());
-    lv_obj_set_style_text_font(temp_tag_label, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_font(temp_val_label, &lv_font_montserrat_32, 0);
-    lv_obj_align(temp_tag_label, LV_ALIGN_TOP_LEFT, 10, 0);
-    lv_obj_align(temp_val_label, LV_ALIGN_TOP_RIGHT, -12, 18);
-
-    // Set up humidity labels
-    hum_tag_label = lv_label_create(lv_scr_act());
-    hum_val_label = lv_label_create(lv_scr_act());
-    lv_obj_set_style_text_font(hum_tag_label, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_font(hum_val_label, &lv_font_montserrat_32, 0);
-    lv_obj_align(hum_tag_label, LV_ALIGN_TOP_LEFT, 10, 52);
-    lv_obj_align(hum_val_label, LV_ALIGN_TOP_RIGHT, -12, 70);
-
-    // Set up CO2 labels
-    co2_tag_label = lv_label_create(lv_scr_act());
-    co2_val_label = lv_label_create(lv_scr_act());
-    lv_obj_set_style_text_font(co2_tag_label, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_font(co2_val_label, &lv_font_montserrat_32, 0);
-    lv_obj_align(co2_tag_label, LV_ALIGN_TOP_LEFT, 10, 104);
-    lv_obj_align(co2_val_label, LV_ALIGN_TOP_RIGHT, -12, 122);
-
-    // Set up VOC labels
-    voc_val_label = lv_label_create(lv_scr_act());
-    voc_tag_label = lv_label_create(lv_scr_act());
-    lv_obj_set_style_text_font(voc_tag_label, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_font(voc_val_label, &lv_font_montserrat_24, 0);
-    lv_obj_align(voc_tag_label, LV_ALIGN_TOP_LEFT, 10, 156);
-    lv_obj_align(voc_val_label, LV_ALIGN_TOP_RIGHT, -12, 173);
-
-    // Set up battery percentage label
-    batt_tag_label = lv_label_create(lv_scr_act());
-    batt_val_label = lv_label_create(lv_scr_act());
-    lv_obj_set_style_text_font(batt_tag_label, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_font(batt_val_label, &lv_font_montserrat_32, 0);
-    lv_obj_align(batt_tag_label, LV_ALIGN_TOP_LEFT, 10, 198);
-    lv_obj_align(batt_val_label, LV_ALIGN_TOP_RIGHT, -12, 215);
+    int rc = renderer_init(epd_dev, layout, chart_layout);
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to initialize display renderer (err %d).", rc);
+        return rc;
+    }
 
     // Turn off display blanking to activate partial updates
     display_blanking_off(epd_dev);
 
+    // Suspended until acquired for updating
+    rc = pm_device_runtime_enable(epd_dev);
+    if (rc == -ENOTSUP)
+    {
+        LOG_WRN("Display device has no power management, keeping it active.");
+    }
+    else if (rc != 0)
+    {
+        LOG_ERR("Failed to enable runtime power management for EPD device (err %d).", rc);
+        return rc;
+    }
+
+    // The renderer is only used from the display work queue from here on
+    k_work_queue_start(&display_work_q, display_stack, DISPLAY_THREAD_STACK_SIZE, DISPLAY_THREAD_PRIORITY, NULL);
+    k_work_init(&display_work, display_task);
+
     return 0;
 }
 
-int display_notification(const char *message)
+/**
+ * @brief Add the ghosting damage of a partial update of a field, a fixed cost plus one point per changed character
+ *
+ * @param field Field being updated
+ * @param old_text Text shown before the update
+ * @param new_text Text shown after the update
+ */
+static void add_damage(display_field_t field, const char *old_text, const char *new_text)
 {
-    lv_label_set_text(notif_label, "");
-    lv_label_set_text(temp_tag_label, "");
-    lv_label_set_text(temp_val_label, "");
-    lv_label_set_text(hum_tag_label, "");
-    lv_label_set_text(hum_val_label, "");
-    lv_label_set_text(co2_tag_label, "");
-    lv_label_set_text(co2_val_label, "");
-    lv_label_set_text(voc_val_label, "");
-    lv_label_set_text(voc_tag_label, "");
-    lv_label_set_text(batt_tag_label, "");
-    lv_label_set_text(batt_val_label, "");
-    lv_label_set_text(notif_label, message);
-    lv_task_handler();
-    return 0;
+    uint32_t damage = CONFIG_EPD_DAMAGE_PER_UPDATE;
+    while (*old_text != '\0' || *new_text != '\0')
+    {
+        if (*old_text != *new_text)
+        {
+            damage++;
+        }
+        if (*old_text != '\0')
+        {
+            old_text++;
+        }
+        if (*new_text != '\0')
+        {
+            new_text++;
+        }
+    }
+    region_damage[field] += damage;
 }
 
-int update_e_paper_display(void)
+/**
+ * @brief Add the ghosting damage of a partial update of a chart
+ *
+ * @param chart Chart being updated
+ */
+static void add_chart_damage(display_chart_t chart)
+{
+    region_damage[NUM_DISPLAY_FIELDS + chart] += CONFIG_EPD_DAMAGE_PER_UPDATE;
+}
+
+static uint32_t get_max_damage(void)
+{
+    uint32_t max = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(region_damage); i++)
+    {
+        max = MAX(max, region_damage[i]);
+    }
+    return max;
+}
+
+/**
+ * @brief Set the text of a field if it differs from the shown text, unchanged fields are not redrawn
+ *
+ * @param field Field to set
+ * @param text New text
+ * @return true if the text changed, false if not
+ */
+static bool set_field_text(display_field_t field, const char *text)
 {
-    static int refresh_count = 0;
+    const char *old_text = renderer_get_text(field);
+    if (strcmp(old_text, text) == 0)
+    {
+        return false;
+    }
+    add_damage(field, old_text, text);
+    renderer_set_text(field, text);
+    return true;
+}
 
-    lv_label_set_text(notif_label, "");
-    snprintf(label_buffer, sizeof(label_buffer), "Temperature");
-    lv_label_set_text(temp_tag_label, label_buffer);
-    snprintf(label_buffer, sizeof(label_buffer), "Humidity");
-    lv_label_set_text(hum_tag_label, label_buffer);
-    snprintf(label_buffer, sizeof(label_buffer), "CO2 (ppm)");
-    lv_label_set_text(co2_tag_label, label_buffer);
-    snprintf(label_buffer, sizeof(label_buffer), "Air quality");
-    lv_label_set_text(voc_tag_label, label_buffer);
-    snprintf(label_buffer, sizeof(label_buffer), "Battery");
-    lv_label_set_text(batt_tag_label, label_buffer);
+/**
+ * @brief Show or hide the trend charts
+ *
+ * @param visible True to show the charts
+ * @return true if the charts changed, false if not
+ */
+static bool show_charts(bool visible)
+{
+#ifdef CONFIG_DISPLAY_TREND
+    if (visible == charts_visible)
+    {
+        return false;
+    }
+    charts_visible = visible;
+    for (int i = 0; i < NUM_DISPLAY_CHARTS; i++)
+    {
+        renderer_show_chart(i, visible);
+        add_chart_damage(i);
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef CONFIG_DISPLAY_TREND
+/**
+ * @brief Append the mean of the collected samples as the newest column of a chart, 0 if there were none
+ *
+ * @param chart Chart to append to
+ * @param min Value at the bottom of the chart
+ * @param max Value at the top of the chart
+ */
+static void push_trend_column(display_chart_t chart, float min, float max)
+{
+    trend_column_t *column = &trend_columns[chart];
+    uint8_t height = chart_layout[chart].height;
+    uint8_t level = 0;
+    if (column->count > 0)
+    {
+        // Values at or below the minimum still get a one pixel bar, unlike missing values
+        float mean = column->sum / column->count;
+        float scaled = (mean - min) / (max - min) * (height - 1) + 1.5f;
+        level = CLAMP((int)scaled, 1, height);
+    }
+    renderer_push_chart(chart, level);
+    if (charts_visible)
+    {
+        add_chart_damage(chart);
+    }
+    memset(column, 0, sizeof(*column));
+}
+
+/**
+ * @brief Collect the values of a snapshot and append a chart column for every elapsed column period. Periods without
+ * any snapshot, e.g. while a notification was shown, get empty columns.
+ *
+ * @param snapshot Values to collect
+ * @return true if the shown charts changed, false if not
+ */
+static bool update_trends(const display_snapshot_t *snapshot)
+{
+    const int64_t period_ms = (int64_t)CONFIG_DISPLAY_TREND_COLUMN_S * MSEC_PER_SEC;
+
+    int64_t now = k_uptime_get();
+    bool changed = false;
+    for (int i = 0; i < RENDERER_CHART_MAX_WIDTH && now - trend_column_start_ms >= period_ms; i++)
+    {
+        push_trend_column(CHART_TEMPERATURE, CONFIG_DISPLAY_TREND_TEMPERATURE_MIN, CONFIG_DISPLAY_TREND_TEMPERATURE_MAX);
+        push_trend_column(CHART_CO2, CONFIG_DISPLAY_TREND_CO2_MIN, CONFIG_DISPLAY_TREND_CO2_MAX);
+        trend_column_start_ms += period_ms;
+        // Hidden charts are drawn with their columns once shown again, there is nothing to refresh
+        changed = charts_visible;
+    }
+    if (now - trend_column_start_ms >= period_ms)
+    {
+        // Gap longer than the charts, start over from now
+        trend_column_start_ms = now;
+    }
+
+    // The snapshot belongs to the column started last
+    if (snapshot->temperature != -1)
+    {
+        trend_columns[CHART_TEMPERATURE].sum += snapshot->temperature;
+        trend_columns[CHART_TEMPERATURE].count++;
+    }
+    if (snapshot->co2 != -1)
+    {
+        trend_columns[CHART_CO2].sum += snapshot->co2;
+        trend_columns[CHART_CO2].count++;
+    }
+    return changed;
+}
+#endif
+
+/**
+ * @brief Get the value to display for a field, the shown value is kept while the latest value stays within the
+ * deadband and the shown value is not stale
+ *
+ * @param field Hysteresis state of the field
+ * @param value Latest value, -1 if none
+ * @param deadband Minimum change before the shown value is replaced
+ * @param held Set to true if a different latest value was held back
+ * @return float, value to display
+ */
+static float apply_hysteresis(field_hysteresis_t *field, float value, float deadband, bool *held)
+{
+    int64_t now = k_uptime_get();
+    bool stale = CONFIG_DISPLAY_STALE_TIMEOUT_S > 0 &&
+                 now - field->shown_ms >= (int64_t)CONFIG_DISPLAY_STALE_TIMEOUT_S * MSEC_PER_SEC;
+    bool moved = value != field->shown &&
+                 (value == -1 || field->shown == -1 || fabsf(value - field->shown) >= deadband);
+
+    if (moved || stale)
+    {
+        if (moved)
+        {
+            last_deadband_exit_ms = now;
+        }
+        field->shown = value;
+        field->shown_ms = now;
+    }
+    else if (value != field->shown)
+    {
+        *held = true;
+    }
+    return field->shown;
+}
+
+/**
+ * @brief Push the invalidated areas to the EPD, the EPD is resumed only for the duration of the refresh
+ *
+ * @param full True to blank the whole panel first to clear ghosting
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int refresh_display(bool full)
+{
+    int rc = 0;
+#ifdef CONFIG_STATE_STATS
+    int64_t start_ms = k_uptime_get();
+#endif
+    rc = power_get(POWER_EPD);
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to acquire EPD device (err %d).", rc);
+        return rc;
+    }
+
+    if (full)
+    {
+        LOG_INF("Full refresh, max region damage %u.", get_max_damage());
+        display_blanking_on(epd_dev);
+        display_blanking_off(epd_dev);
+        memset(region_damage, 0, sizeof(region_damage));
+    }
+    uint32_t start_cycles = k_cycle_get_32();
+    rc = renderer_flush();
+    uint32_t elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - start_cycles);
+    render_time_us += elapsed_us;
+    LOG_INF("Rendered and written in %u us.", elapsed_us);
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to render display (err %d).", rc);
+    }
+    last_refresh_ms = k_uptime_get();
+    pending_changes = false;
+    display_refreshes++;
+
+    int put_rc = power_put(POWER_EPD);
+#ifdef CONFIG_STATE_STATS
+    // Not a state of its own anymore, the refresh overlaps with advertising or idling
+    record_parallel_state(UPDATING, k_uptime_get() - start_ms);
+#endif
+    return rc != 0 ? rc : put_rc;
+}
+
+/**
+ * @brief Switch a slot to its other buffer to write a new text into
+ *
+ * @param slot Slot to write to
+ * @return char*, buffer of TEXT_SLOT_SIZE bytes
+ */
+static char *next_slot_text(text_slot_t *slot)
+{
+    slot->shown = !slot->shown;
+    return slot->text[slot->shown];
+}
+
+/**
+ * @brief Replace the displayed values with a notification message
+ *
+ * @param message Message to display
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int render_notification(const char *message)
+{
+    bool changed = false;
+    changed |= set_field_text(FIELD_TEMPERATURE_TAG, "");
+    changed |= set_field_text(FIELD_TEMPERATURE_VALUE, "");
+    changed |= set_field_text(FIELD_HUMIDITY_TAG, "");
+    changed |= set_field_text(FIELD_HUMIDITY_VALUE, "");
+    changed |= set_field_text(FIELD_CO2_TAG, "");
+    changed |= set_field_text(FIELD_CO2_VALUE, "");
+    changed |= set_field_text(FIELD_VOC_VALUE, "");
+    changed |= set_field_text(FIELD_VOC_TAG, "");
+    changed |= set_field_text(FIELD_BATTERY_TAG, "");
+    changed |= set_field_text(FIELD_BATTERY_VALUE, "");
+    // The message lives in the snapshot, the renderer needs a copy that outlasts it
+    if (strcmp(notification_slot.text[notification_slot.shown], message) != 0)
+    {
+        snprintf(next_slot_text(&notification_slot), TEXT_SLOT_SIZE, "%s", message);
+    }
+    changed |= set_field_text(FIELD_NOTIFICATION, notification_slot.text[notification_slot.shown]);
+    changed |= show_charts(false);
+    if (!changed)
+    {
+        return 0;
+    }
+    return refresh_display(get_max_damage() >= CONFIG_EPD_DAMAGE_THRESHOLD);
+}
+
+/**
+ * @brief Set the text of a field if it is part of the face, fields not on the face are cleared
+ *
+ * @param face Face being shown
+ * @param field Field to set
+ * @param text New text
+ * @return true if the text changed, false if not
+ */
+static bool set_face_text(display_face_t face, display_field_t field, const char *text)
+{
+    bool on_face = face == DISPLAY_FACE_DASHBOARD || field == FIELD_CO2_TAG || field == FIELD_CO2_VALUE;
+    return set_field_text(field, on_face ? text : "");
+}
+
+/**
+ * @brief Show a fixed point value in a field, the text is only formatted again when the value changed
+ *
+ * @param face Face being shown
+ * @param field Field to set
+ * @param slot Text slot of the field
+ * @param value Value in units of the last decimal
+ * @param decimals Number of digits after the decimal point
+ * @param suffix Unit after the number
+ * @return true if the text changed, false if not
+ */
+static bool set_value_text(display_face_t face, display_field_t field, text_slot_t *slot, int32_t value,
+                           uint8_t decimals, const char *suffix)
+{
+    if (value != slot->value)
+    {
+        format_decimal(next_slot_text(slot), TEXT_SLOT_SIZE, value, decimals, suffix);
+        slot->value = value;
+    }
+    return set_face_text(face, field, slot->text[slot->shown]);
+}
+
+/**
+ * @brief Hide the notification and show the tags of the values and the charts on the face. The texts set here
+ * determine the characters of the tag font, see CMakeLists.txt.
+ *
+ * @param face Face being shown
+ * @return true if a field changed, false if not
+ */
+static bool set_tags(display_face_t face)
+{
+    bool changed = false;
+    changed |= set_field_text(FIELD_NOTIFICATION, "");
+    changed |= set_face_text(face, FIELD_TEMPERATURE_TAG, "Temperature");
+    changed |= set_face_text(face, FIELD_HUMIDITY_TAG, "Humidity");
+    changed |= set_face_text(face, FIELD_CO2_TAG, "CO2 (ppm)");
+    changed |= set_face_text(face, FIELD_VOC_TAG, "Air quality");
+    changed |= set_face_text(face, FIELD_BATTERY_TAG, "Battery");
+    changed |= show_charts(face == DISPLAY_FACE_DASHBOARD);
+    return changed;
+}
+
+/**
+ * @brief Show the values of a snapshot, values within their deadband keep the shown value
+ *
+ * @param snapshot Values to show
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int render_values(const display_snapshot_t *snapshot)
+{
+    bool held = false;
+    bool values_changed = false;
+    display_plan_t plan = select_display_plan(snapshot->battery_level, k_uptime_get() - last_value_change_ms);
+
+    // Tags only change when coming back from a notification or when the face changes
+    bool changed = set_tags(plan.face);
+
+#ifdef CONFIG_DISPLAY_TREND
+    // The charts follow the measured values, not the values held by the deadbands
+    changed |= update_trends(snapshot);
+#endif
 
     // Set temperature
-    float temp = get_latest(TEMPERATURE);
+    float temp = apply_hysteresis(&temp_hysteresis, snapshot->temperature,
+                                  CONFIG_DISPLAY_TEMPERATURE_DEADBAND / 100.0f, &held);
     if (temp == -1)
     {
-        lv_label_set_text(temp_val_label, "n/a");
+        values_changed |= set_face_text(plan.face, FIELD_TEMPERATURE_VALUE, "n/a");
     }
     else
     {
-        snprintf(label_buffer, sizeof(label_buffer), "%d.%01d"
-                                                     "\xB0"
-                                                     "C",
-                 (int)temp, (int)((temp - (int)temp) * 10));
-        lv_label_set_text(temp_val_label, label_buffer);
+        values_changed |= set_value_text(plan.face, FIELD_TEMPERATURE_VALUE, &temp_slot, (int32_t)(temp * 10), 1,
+                                         "\xB0"
+                                         "C");
     }
 
     // Set humidity
-    float hum = get_latest(HUMIDITY);
+    float hum = apply_hysteresis(&hum_hysteresis, snapshot->humidity, CONFIG_DISPLAY_HUMIDITY_DEADBAND, &held);
     if (hum == -1)
     {
-        lv_label_set_text(hum_val_label, "n/a");
+        values_changed |= set_face_text(plan.face, FIELD_HUMIDITY_VALUE, "n/a");
     }
     else
     {
-        snprintf(label_buffer, sizeof(label_buffer), "%d%%", (int)hum);
-        lv_label_set_text(hum_val_label, label_buffer);
+        values_changed |= set_value_text(plan.face, FIELD_HUMIDITY_VALUE, &hum_slot, (int32_t)hum, 0, "%");
     }
 
     // Set CO2 concentration
-    float co2 = get_latest(CO2_CONCENTRATION);
+    float co2 = apply_hysteresis(&co2_hysteresis, snapshot->co2, CONFIG_DISPLAY_CO2_DEADBAND, &held);
     if (co2 == -1)
     {
-        lv_label_set_text(co2_val_label, "n/a");
+        values_changed |= set_face_text(plan.face, FIELD_CO2_VALUE, "n/a");
     }
     else
     {
-        snprintf(label_buffer, sizeof(label_buffer), "%d", (int)co2);
-        lv_label_set_text(co2_val_label, label_buffer);
+        values_changed |= set_value_text(plan.face, FIELD_CO2_VALUE, &co2_slot, (int32_t)co2, 0, "");
     }
 
     // Set VOC index air quality label
-    float voc = get_latest(VOC_INDEX);
-    snprintf(label_buffer, sizeof(label_buffer), "%s", air_quality_from_voc_index((int)voc));
-    lv_label_set_text(voc_val_label, label_buffer);
+    float voc = apply_hysteresis(&voc_hysteresis, snapshot->voc_index, CONFIG_DISPLAY_VOC_INDEX_DEADBAND, &held);
+    values_changed |= set_face_text(plan.face, FIELD_VOC_VALUE, air_quality_from_voc_index((int)voc));
 
     // Set battery percentage
-    float bat = get_latest(BATTERY_LEVEL);
+    float bat = apply_hysteresis(&batt_hysteresis, snapshot->battery_level, CONFIG_DISPLAY_BATTERY_DEADBAND, &held);
     if (bat == -1)
     {
-        lv_label_set_text(batt_val_label, "n/a");
+        values_changed |= set_face_text(plan.face, FIELD_BATTERY_VALUE, "n/a");
     }
     else
     {
-        snprintf(label_buffer, sizeof(label_buffer), "%d%%", (int)bat);
-        lv_label_set_text(batt_val_label, label_buffer);
+        values_changed |= set_value_text(plan.face, FIELD_BATTERY_VALUE, &batt_slot, (int32_t)bat, 0, "%");
     }
 
-    refresh_count++;
-    if (refresh_count >= 10)
+    if (values_changed)
     {
-        // Full refresh every 10th update to avoid ghosting
-        display_blanking_on(epd_dev);
-        display_blanking_off(epd_dev);
-        refresh_count = 0;
+        // A changed value ends a stable period, so it is not held back by the stable refresh interval
+        last_value_change_ms = k_uptime_get();
+        plan = select_display_plan(snapshot->battery_level, 0);
     }
+    changed |= values_changed || pending_changes;
 
-    lv_task_handler();
+    // Clear moderate ghosting while nobody is likely to look, e.g. overnight in an empty room
+    uint32_t damage = get_max_damage();
+    bool quiet = k_uptime_get() - last_deadband_exit_ms >= (int64_t)CONFIG_EPD_QUIET_PERIOD_S * MSEC_PER_SEC;
+    if (plan.opportunistic_full && quiet && damage >= CONFIG_EPD_OPPORTUNISTIC_DAMAGE_THRESHOLD)
+    {
+        return refresh_display(true);
+    }
+
+    // Nothing visible changed, leave the EPD suspended
+    if (!changed)
+    {
+        if (held)
+        {
+            skipped_refreshes++;
+        }
+        LOG_INF("Displayed values unchanged, skipping refresh (%u skipped by hysteresis).", skipped_refreshes);
+        return 0;
+    }
+
+    // Changes within the refresh interval of the mode stay on the renderer until the next refresh
+    if (k_uptime_get() - last_refresh_ms < (int64_t)plan.min_interval_s * MSEC_PER_SEC)
+    {
+        pending_changes = true;
+        deferred_refreshes++;
+        LOG_INF("Refresh deferred in %s mode (%u deferred).", display_mode_to_string(plan.mode), deferred_refreshes);
+        return 0;
+    }
+
+    // Full refresh only once a region accumulated enough partial updates to show ghosting
+    bool full = damage >= plan.damage_threshold;
+    return refresh_display(full);
+}
+
+/**
+ * @brief Render and refresh the latest submitted snapshot
+ *
+ * @param work Address of work item.
+ */
+static void display_task(struct k_work *work)
+{
+    display_snapshot_t snapshot;
+    k_mutex_lock(&snapshot_mutex, K_FOREVER);
+    snapshot = pending_snapshot;
+    k_mutex_unlock(&snapshot_mutex);
+
+    int rc = snapshot.notification ? render_notification(snapshot.message) : render_values(&snapshot);
+    if (rc != 0)
+    {
+        LOG_ERR("Error updating E-paper display (err %d).", rc);
+        dispatch_event(PERIODIC_TASK_WARNING);
+    }
+}
+
+/**
+ * @brief Hand a snapshot over to the display work queue
+ *
+ * @param snapshot Snapshot to show
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int submit_snapshot(const display_snapshot_t *snapshot)
+{
+    k_mutex_lock(&snapshot_mutex, K_FOREVER);
+    pending_snapshot = *snapshot;
+    k_mutex_unlock(&snapshot_mutex);
 
+    // Already queued work picks up the new snapshot, running work is queued again
+    int rc = k_work_submit_to_queue(&display_work_q, &display_work);
+    if (rc < 0)
+    {
+        LOG_ERR("Error submitting display update (err %d).", rc);
+        return rc;
+    }
     return 0;
 }
 
+int display_notification(const char *message)
+{
+    display_snapshot_t snapshot = {.notification = true};
+    snprintf(snapshot.message, sizeof(snapshot.message), "%s", message);
+    return submit_snapshot(&snapshot);
+}
+
+int update_e_paper_display(void)
+{
+    display_snapshot_t snapshot = {
+        .notification = false,
+        .temperature = get_latest(TEMPERATURE),
+        .humidity = get_latest(HUMIDITY),
+        .co2 = get_latest(CO2_CONCENTRATION),
+        .voc_index = get_latest(VOC_INDEX),
+        .battery_level = get_latest(BATTERY_LEVEL),
+    };
+    return submit_snapshot(&snapshot);
+}
+
+uint32_t get_display_refreshes(void)
+{
+    return display_refreshes;
+}
+
+uint32_t get_skipped_refreshes(void)
+{
+    return skipped_refreshes;
+}
+
+uint32_t get_deferred_refreshes(void)
+{
+    return deferred_refreshes;
+}
+
+uint64_t get_display_render_time_us(void)
+{
+    return render_time_us;
+}
+
 int activate_epd(void)
 {
     LOG_INF("Activating EPD.");
     int rc = 0;
-    rc = pm_device_action_run(epd_dev, PM_DEVICE_ACTION_RESUME);
+    rc = pm_device_runtime_get(epd_dev);
     if (rc != 0)
     {
         LOG_ERR("Failed to activate EPD device (err %d).", rc);
@@ -219,7 +735,7 @@ int suspend_epd(void)
 {
     LOG_INF("Suspending EPD.");
     int rc = 0;
-    rc = pm_device_action_run(epd_dev, PM_DEVICE_ACTION_SUSPEND);
+    rc = pm_device_runtime_put(epd_dev);
     if (rc != 0)
     {
         LOG_ERR("Failed to suspend EPD device (err %d).", rc);
@@ -3,6 +3,7 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/device.h>
 #include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
 
 LOG_MODULE_REGISTER(flash_manager);
 
@@ -16,6 +17,19 @@ int init_flash_manager(void)
         LOG_ERR("Device P25Q16H is not ready.");
         return -ENXIO;
     }
+
+    // Suspended right away, the settings live in the internal flash and nothing else uses the external one. The driver
+    // holds the flash active by itself for the duration of each operation.
+    int rc = pm_device_runtime_enable(qspi_dev);
+    if (rc == -ENOTSUP)
+    {
+        LOG_WRN("Flash device has no power management, keeping it active.");
+    }
+    else if (rc != 0)
+    {
+        LOG_ERR("Failed to enable runtime power management for P25Q16H (err %d).", rc);
+        return rc;
+    }
     return 0;
 }
 
@@ -23,7 +37,7 @@ int activate_flash(void)
 {
     LOG_INF("Activating flash.");
     int rc = 0;
-    rc = pm_device_action_run(qspi_dev, PM_DEVICE_ACTION_RESUME);
+    rc = pm_device_runtime_get(qspi_dev);
     if (rc != 0)
     {
         LOG_ERR("Failed to activate P25Q16H (err %d).", rc);
@@ -35,7 +49,7 @@ int suspend_flash(void)
 {
     LOG_INF("Suspending flash.");
     int rc = 0;
-    rc = pm_device_action_run(qspi_dev, PM_DEVICE_ACTION_SUSPEND);
+    rc = pm_device_runtime_put(qspi_dev);
     if (rc != 0)
     {
         LOG_ERR("Failed to suspend P25Q16H (err %d).", rc);
@@ -0,0 +1,91 @@
+#include <components/power_manager.h>
+#include <components/sensors.h>
+#include <components/e_paper_display.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(power_manager);
+
+typedef struct
+{
+    int (*resume)(void);
+    int (*suspend)(void);
+    uint8_t users;
+    uint32_t transitions;
+} power_domain_state_t;
+
+static power_domain_state_t domains[NUM_POWER_DOMAINS] = {
+    [POWER_SENSORS] = {.resume = activate_sensors, .suspend = suspend_sensors},
+    [POWER_EPD] = {.resume = activate_epd, .suspend = suspend_epd},
+};
+
+// Users may acquire peripherals from both the main thread and the periodic task work queue
+K_MUTEX_DEFINE(power_mutex);
+
+int power_get(power_domain_t domain)
+{
+    if (domain >= NUM_POWER_DOMAINS)
+    {
+        return -EINVAL;
+    }
+
+    int rc = 0;
+    power_domain_state_t *state = &domains[domain];
+    k_mutex_lock(&power_mutex, K_FOREVER);
+    if (state->users == 0 && state->resume)
+    {
+        rc = state->resume();
+        state->transitions++;
+        LOG_DBG("%s resumed, %u transitions.", power_domain_to_string(domain), state->transitions);
+    }
+    if (rc == 0)
+    {
+        state->users++;
+    }
+    k_mutex_unlock(&power_mutex);
+    return rc;
+}
+
+int power_put(power_domain_t domain)
+{
+    if (domain >= NUM_POWER_DOMAINS)
+    {
+        return -EINVAL;
+    }
+
+    int rc = 0;
+    power_domain_state_t *state = &domains[domain];
+    k_mutex_lock(&power_mutex, K_FOREVER);
+    if (state->users == 0)
+    {
+        LOG_ERR("Unbalanced release of %s.", power_domain_to_string(domain));
+        rc = -EALREADY;
+    }
+    else if (--state->users == 0 && state->suspend)
+    {
+        rc = state->suspend();
+        state->transitions++;
+        LOG_DBG("%s suspended, %u transitions.", power_domain_to_string(domain), state->transitions);
+    }
+    k_mutex_unlock(&power_mutex);
+    return rc;
+}
+
+uint32_t get_power_transitions(power_domain_t domain)
+{
+    return domain < NUM_POWER_DOMAINS ? domains[domain].transitions : 0;
+}
+
+const char *power_domain_to_string(power_domain_t domain)
+{
+    switch (domain)
+    {
+    case POWER_SENSORS:
+        return "SENSORS";
+    case POWER_EPD:
+        return "EPD";
+    default:
+        return "UNKNOWN_DOMAIN";
+    }
+}
@@ -1,5 +1,8 @@
 #include <components/sensors.h>
+#include <components/state_manager.h>
 #include <utils/variable_buffer.h>
+#include <utils/gas_index_state.h>
+#include <utils/gas_index_fixed.h>
 
 #include <sensirion_gas_index_algorithm.h>
 
@@ -9,28 +12,68 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/pm/pm.h>
 #include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+
+#include <math.h>
 
 LOG_MODULE_REGISTER(sensors);
 
+// Time between two measurement cycles in seconds
+#define MEASUREMENT_INTERVAL_S (CONFIG_ADVERTISEMENT_INTERVAL / CONFIG_MEASUREMENTS_PER_INTERVAL / 1000)
+
 #ifdef CONFIG_ENABLE_SHT4X
 #include <zephyr/drivers/sensor/sht4x.h>
 static const struct device *sht4x_dev_p;
-static struct sensor_value temperature, humidity;
+#endif
+
+#if defined(CONFIG_ENABLE_SHT4X) || defined(CONFIG_ENABLE_SGP40)
+// SGP40 compensation, the Sensirion default values until the first SHT4X read. Written by the measurement thread and
+// read by the SGP40 duty cycle on the system work queue, only accessed under the lock
+static struct sensor_value temperature = {25, 0}, humidity = {50, 0};
+static struct k_spinlock compensation_lock;
 #endif
 
 #ifdef CONFIG_ENABLE_SGP40
 #include <zephyr/drivers/sensor/sgp40.h>
 static const struct device *sgp40_dev_p;
 static struct sensor_value voc_raw, voc_index;
+#ifdef CONFIG_GAS_INDEX_FIXED_POINT
+static gas_index_fixed_params_t voc_params;
+#else
 static GasIndexAlgorithmParams voc_params;
 #endif
+#ifdef CONFIG_SGP40_LOW_POWER_MODE
+// The SGP40 is sampled on its own duty cycle, at the interval the gas index algorithm is tuned for
+#define SGP40_SAMPLING_INTERVAL_S CONFIG_SGP40_LOW_POWER_INTERVAL_S
+#define SGP40_CONDITIONING_PERIOD_MS 1000
+BUILD_ASSERT(CONFIG_SGP40_CONDITIONING_SAMPLES < CONFIG_SGP40_LOW_POWER_INTERVAL_S,
+             "SGP40 conditioning burst must fit in the sampling interval");
+static void sgp40_duty_cycle(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(sgp40_duty_cycle_work, sgp40_duty_cycle);
+static uint8_t sgp40_burst_count;
+static int64_t sgp40_burst_start_ms;
+// Written by the duty cycle and read by the measurement thread under the compensation lock
+static float latest_voc_index = -1.0f;
+#else
+#define SGP40_SAMPLING_INTERVAL_S MEASUREMENT_INTERVAL_S
+#endif
+#endif
 
 #ifdef CONFIG_ENABLE_SCD4X
 #include <drivers/scd4x.h>
 static const struct device *scd4x_dev_p;
+// ASC periods are counted in 5 minute single shots (12 per hour), scale them by the CO2 measurement interval
+// and round to the multiple of 4 hours required by the sensor
+#define SCD4X_CO2_INTERVAL_S (MEASUREMENT_INTERVAL_S * CONFIG_SCD4X_CO2_MEASUREMENT_INTERVAL)
+#define SCD4X_ASC_PERIOD(period_s) MAX(4, (((period_s) / SCD4X_CO2_INTERVAL_S / 12 + 2) / 4) * 4)
 static struct sensor_value co2_concentration, temperature_2, humidity_2;
-static struct sensor_value asc_initial_period = {(2 * 24 * 60 * 60) / (CONFIG_ADVERTISEMENT_INTERVAL / CONFIG_MEASUREMENTS_PER_INTERVAL / 1000) / 12, 0};
-static struct sensor_value asc_standard_period = {(7 * 24 * 60 * 60) / (CONFIG_ADVERTISEMENT_INTERVAL / CONFIG_MEASUREMENTS_PER_INTERVAL / 1000) / 12, 0};
+static struct sensor_value asc_initial_period = {SCD4X_ASC_PERIOD(2 * 24 * 60 * 60), 0};
+static struct sensor_value asc_standard_period = {SCD4X_ASC_PERIOD(7 * 24 * 60 * 60), 0};
+// Full CO2 measurement schedule, start with a full measurement
+static uint8_t cycles_since_co2 = CONFIG_SCD4X_CO2_MEASUREMENT_INTERVAL;
+static float latest_co2 = -1.0f;
+static float previous_co2 = -1.0f;
+static bool co2_measuring;
 static struct sensor_value sensor_altitude = {CONFIG_SCD4X_ALTITUDE, 0};
 static struct sensor_value temperature_offset = {CONFIG_SCD4X_TEMPERATURE_OFFSET, 0};
 #endif
@@ -41,6 +84,93 @@ static const struct device *bmp390_dev_p;
 static struct sensor_value pressure, temperature_3;
 #endif
 
+#ifdef CONFIG_ENABLE_SGP40
+#ifdef CONFIG_GAS_INDEX_PERSIST_STATE
+/**
+ * @brief Get the VOC gas index algorithm states from the selected implementation
+ *
+ * @param state0 Mean state
+ * @param state1 Standard deviation state
+ */
+static void get_voc_algorithm_states(float *state0, float *state1)
+{
+#ifdef CONFIG_GAS_INDEX_FIXED_POINT
+    gas_index_fixed_get_states(&voc_params, state0, state1);
+#else
+    GasIndexAlgorithm_get_states(&voc_params, state0, state1);
+#endif
+}
+#endif
+
+/**
+ * @brief Initialize the VOC gas index algorithm and restore its states when a usable checkpoint is stored
+ */
+static void init_voc_algorithm(void)
+{
+#ifdef CONFIG_GAS_INDEX_FIXED_POINT
+    gas_index_fixed_init(&voc_params, SGP40_SAMPLING_INTERVAL_S);
+#else
+    GasIndexAlgorithm_init_with_sampling_interval(&voc_params, GasIndexAlgorithm_ALGORITHM_TYPE_VOC, SGP40_SAMPLING_INTERVAL_S);
+#endif
+
+#ifdef CONFIG_GAS_INDEX_PERSIST_STATE
+    // Non-critical, without the states the algorithm starts learning from scratch
+    float state0, state1;
+    if (restore_gas_index_state(&state0, &state1) == 0)
+    {
+#ifdef CONFIG_GAS_INDEX_FIXED_POINT
+        gas_index_fixed_set_states(&voc_params, state0, state1);
+#else
+        GasIndexAlgorithm_set_states(&voc_params, state0, state1);
+#endif
+    }
+#endif
+}
+
+/**
+ * @brief Process a raw VOC sample with the gas index algorithm and checkpoint the states when due
+ *
+ * @param sraw Raw VOC ticks
+ * @param gas_index Calculated VOC index
+ */
+static void process_voc_algorithm(int32_t sraw, int32_t *gas_index)
+{
+#ifdef CONFIG_GAS_INDEX_FIXED_POINT
+    gas_index_fixed_process(&voc_params, sraw, gas_index);
+#else
+    GasIndexAlgorithm_process(&voc_params, sraw, gas_index);
+#endif
+
+#ifdef CONFIG_GAS_INDEX_PERSIST_STATE
+    float state0, state1;
+    get_voc_algorithm_states(&state0, &state1);
+    update_gas_index_state(SGP40_SAMPLING_INTERVAL_S, state0, state1);
+#endif
+}
+#endif
+
+/**
+ * @brief Enable runtime power management of a sensor, it is suspended until powered up for a measurement
+ *
+ * @param dev Sensor device
+ * @param name Name of the sensor for the log
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int enable_sensor_pm(const struct device *dev, const char *name)
+{
+    int rc = pm_device_runtime_enable(dev);
+    if (rc == -ENOTSUP)
+    {
+        LOG_WRN("Device %s has no power management, keeping it active.", name);
+    }
+    else if (rc != 0)
+    {
+        LOG_ERR("Failed to enable runtime power management for %s (err %d).", name, rc);
+        return rc;
+    }
+    return 0;
+}
+
 int init_sensors(void)
 {
     int rc = 0;
@@ -52,6 +182,11 @@ int init_sensors(void)
         LOG_ERR("Device sht4x is not ready.");
         return -ENXIO;
     }
+    rc = enable_sensor_pm(sht4x_dev_p, "sht4x");
+    if (rc != 0)
+    {
+        return rc;
+    }
 #endif
 
 #ifdef CONFIG_ENABLE_SGP40
@@ -61,7 +196,15 @@ int init_sensors(void)
         LOG_ERR("Device sgp40 is not ready.");
         return -ENXIO;
     }
-    GasIndexAlgorithm_init_with_sampling_interval(&voc_params, GasIndexAlgorithm_ALGORITHM_TYPE_VOC, CONFIG_ADVERTISEMENT_INTERVAL / CONFIG_MEASUREMENTS_PER_INTERVAL / 1000);
+    rc = enable_sensor_pm(sgp40_dev_p, "sgp40");
+    if (rc != 0)
+    {
+        return rc;
+    }
+    init_voc_algorithm();
+#ifdef CONFIG_SGP40_LOW_POWER_MODE
+    k_work_schedule(&sgp40_duty_cycle_work, K_NO_WAIT);
+#endif
 #endif
 
 #ifdef CONFIG_ENABLE_SCD4X
@@ -95,6 +238,12 @@ int init_sensors(void)
         LOG_ERR("Failed to set scd4x sensor temperature offset (err %d).", rc);
         return rc;
     }
+    // After the configuration, which needs the sensor active
+    rc = enable_sensor_pm(scd4x_dev_p, "scd4x");
+    if (rc != 0)
+    {
+        return rc;
+    }
 #endif
 
 #ifdef CONFIG_ENABLE_BMP390
@@ -104,6 +253,11 @@ int init_sensors(void)
         LOG_ERR("Device bmp390 is not ready.");
         return -ENXIO;
     }
+    rc = enable_sensor_pm(bmp390_dev_p, "bmp390");
+    if (rc != 0)
+    {
+        return rc;
+    }
 #endif
 
     // Initialize the buffers for the sensor values
@@ -117,7 +271,42 @@ int init_sensors(void)
     return 0;
 }
 
+/**
+ * @brief Power up a sensor, released with power_down_sensor. Sensors without power management are always active.
+ *
+ * @param dev Sensor device
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int power_up_sensor(const struct device *dev)
+{
+    return pm_device_runtime_get(dev);
+}
+
+/**
+ * @brief Power down a sensor, sensors already powered down are ok
+ *
+ * @param dev Sensor device
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int power_down_sensor(const struct device *dev)
+{
+    int rc = pm_device_runtime_put(dev);
+    return rc == -EALREADY ? 0 : rc;
+}
+
 #ifdef CONFIG_ENABLE_SHT4X
+/**
+ * @brief Power up the SHT4X, it measures on fetch so it is ready after its warm-up
+ *
+ * @param ready_in_ms Output for the time until the sensor is ready
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int start_sht4x(uint32_t *ready_in_ms)
+{
+    *ready_in_ms = CONFIG_SHT4X_WARMUP_TIME_MS;
+    return power_up_sensor(sht4x_dev_p);
+}
+
 /**
  * @brief Read SHT4X sensor data and save the temperature and humidity to the variables
  *
@@ -126,6 +315,7 @@ int init_sensors(void)
 static int read_sht4x_data()
 {
     int rc = 0;
+    struct sensor_value temp, hum;
     rc = sensor_sample_fetch(sht4x_dev_p);
     if (rc != 0)
     {
@@ -135,7 +325,7 @@ static int read_sht4x_data()
         return rc;
     }
 
-    rc = sensor_channel_get(sht4x_dev_p, SENSOR_CHAN_AMBIENT_TEMP, &temperature);
+    rc = sensor_channel_get(sht4x_dev_p, SENSOR_CHAN_AMBIENT_TEMP, &temp);
     if (rc != 0)
     {
         LOG_ERR("Failed to get temperature data (err %d).", rc);
@@ -143,7 +333,7 @@ static int read_sht4x_data()
         set_value(HUMIDITY, -1.0f);    // Error indicator
         return rc;
     }
-    rc = sensor_channel_get(sht4x_dev_p, SENSOR_CHAN_HUMIDITY, &humidity);
+    rc = sensor_channel_get(sht4x_dev_p, SENSOR_CHAN_HUMIDITY, &hum);
     if (rc != 0)
     {
         LOG_ERR("Failed to get humidity data (err %d).", rc);
@@ -152,36 +342,44 @@ static int read_sht4x_data()
         return rc;
     }
 
-    // Save values
-    set_value(TEMPERATURE, sensor_value_to_float(&temperature));
-    set_value(HUMIDITY, sensor_value_to_float(&humidity));
-    LOG_INF("SHT4X temperature: %d.%d °C", temperature.val1, temperature.val2);
-    LOG_INF("SHT4X humidity: %d.%d %%RH", humidity.val1, humidity.val2);
+    // Save values, both at once for the SGP40 compensation
+    k_spinlock_key_t key = k_spin_lock(&compensation_lock);
+    temperature = temp;
+    humidity = hum;
+    k_spin_unlock(&compensation_lock, key);
+    set_value(TEMPERATURE, sensor_value_to_float(&temp));
+    set_value(HUMIDITY, sensor_value_to_float(&hum));
+    LOG_INF("SHT4X temperature: %d.%d °C", temp.val1, temp.val2);
+    LOG_INF("SHT4X humidity: %d.%d %%RH", hum.val1, hum.val2);
     return 0;
 }
 #endif
 
 #ifdef CONFIG_ENABLE_SGP40
 /**
- * @brief Read SGP40 sensor data and save the VOC index to the variables
+ * @brief Do a compensated SGP40 measurement and process it with the gas index algorithm
  *
  * @return int, 0 if ok, non-zero if an error occured
  */
-static int read_sgp40_data()
+static int measure_voc_index()
 {
     int rc = 0;
-    rc = sensor_attr_set(sgp40_dev_p, SENSOR_CHAN_GAS_RES, SENSOR_ATTR_SGP40_TEMPERATURE, &temperature);
+
+    // Snapshot of the latest SHT4X values, the duty cycle runs alongside the measurement thread
+    k_spinlock_key_t key = k_spin_lock(&compensation_lock);
+    struct sensor_value temp = temperature, hum = humidity;
+    k_spin_unlock(&compensation_lock, key);
+
+    rc = sensor_attr_set(sgp40_dev_p, SENSOR_CHAN_GAS_RES, SENSOR_ATTR_SGP40_TEMPERATURE, &temp);
     if (rc != 0)
     {
         LOG_ERR("Failed to set temperature compensation (err %d).", rc);
-        set_value(VOC_INDEX, -1.0f); // Error indicator
         return rc;
     }
-    rc = sensor_attr_set(sgp40_dev_p, SENSOR_CHAN_GAS_RES, SENSOR_ATTR_SGP40_HUMIDITY, &humidity);
+    rc = sensor_attr_set(sgp40_dev_p, SENSOR_CHAN_GAS_RES, SENSOR_ATTR_SGP40_HUMIDITY, &hum);
     if (rc != 0)
     {
         LOG_ERR("Failed to set humidity compensation (err %d).", rc);
-        set_value(VOC_INDEX, -1.0f); // Error indicator
         return rc;
     }
 
@@ -189,7 +387,6 @@ static int read_sgp40_data()
     if (rc != 0)
     {
         LOG_ERR("Failed to fetch sample from SGP40 device (err %d).", rc);
-        set_value(VOC_INDEX, -1.0f); // Error indicator
         return rc;
     }
 
@@ -197,17 +394,36 @@ static int read_sgp40_data()
     if (rc != 0)
     {
         LOG_ERR("Failed to get VOC idnex data (err %d).", rc);
+        return rc;
+    }
+    process_voc_algorithm(voc_raw.val1, &voc_index.val1);
+
+    LOG_INF("SGP40 VOC raw: %d.%d", voc_raw.val1, voc_raw.val2);
+    LOG_INF("SGP40 VOC index (0 - 500): %d.%d", voc_index.val1, voc_index.val2);
+    return 0;
+}
+
+#ifndef CONFIG_SGP40_LOW_POWER_MODE
+/**
+ * @brief Read SGP40 sensor data and save the VOC index to the variables
+ *
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int read_sgp40_data()
+{
+    int rc = 0;
+    rc = measure_voc_index();
+    if (rc != 0)
+    {
         set_value(VOC_INDEX, -1.0f); // Error indicator
         return rc;
     }
-    GasIndexAlgorithm_process(&voc_params, voc_raw.val1, &voc_index.val1);
 
     // Save values
     set_value(VOC_INDEX, sensor_value_to_float(&voc_index));
-    LOG_INF("SGP40 VOC raw: %d.%d", voc_raw.val1, voc_raw.val2);
-    LOG_INF("SGP40 VOC index (0 - 500): %d.%d", voc_index.val1, voc_index.val2);
     return 0;
 }
+#endif
 
 /**
  * @brief Warm up the SGP40 sensor by doing a mock measurement without using the result
@@ -225,9 +441,122 @@ static int warm_up_sgp40()
     }
     return 0;
 }
+
+#ifdef CONFIG_SGP40_LOW_POWER_MODE
+/**
+ * @brief Switch the SGP40 heater off at the end of a burst and account the burst
+ *
+ */
+static void end_sgp40_burst(void)
+{
+    int rc = power_down_sensor(sgp40_dev_p);
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to switch SGP40 heater off (err %d).", rc);
+    }
+    sgp40_burst_count = 0;
+#ifdef CONFIG_STATE_STATS
+    // The heater runs alongside whatever the rest of the device does
+    record_parallel_state(SAMPLING, k_uptime_get() - sgp40_burst_start_ms);
+#endif
+}
+
+/**
+ * @brief SGP40 duty cycle. Every sampling interval the hotplate is conditioned with a burst of 1 Hz samples,
+ * the next sample is processed by the gas index algorithm and the heater is switched off until the next burst.
+ * The bursts need neither the radio nor the other peripherals, so they run at any sleep level and only wake the
+ * kernel.
+ *
+ * @param work Address of work item.
+ */
+static void sgp40_duty_cycle(struct k_work *work)
+{
+    int rc = 0;
+    int64_t delay_ms = SGP40_CONDITIONING_PERIOD_MS;
+
+    if (sgp40_burst_count == 0)
+    {
+        sgp40_burst_start_ms = k_uptime_get();
+        rc = power_up_sensor(sgp40_dev_p);
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to activate SGP40 device (err %d).", rc);
+        }
+    }
+
+    if (sgp40_burst_count < CONFIG_SGP40_CONDITIONING_SAMPLES)
+    {
+        rc = warm_up_sgp40();
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to do a conditioning measurement on the SGP40 (err %d).", rc);
+        }
+        sgp40_burst_count++;
+    }
+    else
+    {
+        rc = measure_voc_index();
+        float index = rc == 0 ? sensor_value_to_float(&voc_index) : -1.0f; // Error indicator
+        k_spinlock_key_t key = k_spin_lock(&compensation_lock);
+        latest_voc_index = index;
+        k_spin_unlock(&compensation_lock, key);
+        end_sgp40_burst();
+        delay_ms = CONFIG_SGP40_LOW_POWER_INTERVAL_S * 1000 - CONFIG_SGP40_CONDITIONING_SAMPLES * SGP40_CONDITIONING_PERIOD_MS;
+    }
+
+    k_work_schedule(&sgp40_duty_cycle_work, K_MSEC(delay_ms));
+}
+#else
+/**
+ * @brief Power up the SGP40 and start warming it up
+ *
+ * @param ready_in_ms Output for the time until the sensor is warmed up
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int start_sgp40(uint32_t *ready_in_ms)
+{
+    int rc = 0;
+    rc = power_up_sensor(sgp40_dev_p);
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to activate SGP40 device (err %d).", rc);
+        set_value(VOC_INDEX, -1.0f); // Error indicator
+        return rc;
+    }
+    rc = warm_up_sgp40();
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to do a warmup measurement on the SGP40 (err %d).", rc);
+        set_value(VOC_INDEX, -1.0f); // Error indicator
+        return rc;
+    }
+    *ready_in_ms = CONFIG_SGP40_WARMUP_TIME_MS;
+    return 0;
+}
+#endif
 #endif
 
 #ifdef CONFIG_ENABLE_BMP390
+/**
+ * @brief Power up the BMP390, forced conversions are done on fetch so it is ready after its warm-up
+ *
+ * @param ready_in_ms Output for the time until the sensor is ready
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int start_bmp390(uint32_t *ready_in_ms)
+{
+    int rc = 0;
+    rc = power_up_sensor(bmp390_dev_p);
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to activate BMP390 device (err %d).", rc);
+        set_value(PRESSURE, -1.0f); // Error indicator
+        return rc;
+    }
+    *ready_in_ms = CONFIG_BMP390_WARMUP_TIME_MS;
+    return 0;
+}
+
 /**
  * @brief Read BMP390 sensor data and save the pressure to the variables
  *
@@ -268,23 +597,157 @@ static int read_bmp390_data()
 
 #ifdef CONFIG_ENABLE_SCD4X
 /**
- * @brief Read SCD4X sensor data and save the temperature, humidity and CO2 levels to the variables
+ * @brief Check whether a full CO2 measurement is due on this cycle
+ *
+ * @return true if a full CO2 single shot should be done, false if it can be skipped
+ */
+static bool scd4x_co2_due(void)
+{
+    if (cycles_since_co2 >= CONFIG_SCD4X_CO2_MEASUREMENT_INTERVAL || latest_co2 < 0)
+    {
+        return true;
+    }
+#if CONFIG_SCD4X_CO2_ADAPTIVE_THRESHOLD > 0
+    // Keep measuring every cycle while the CO2 concentration is changing
+    if (previous_co2 >= 0 && fabsf(latest_co2 - previous_co2) > CONFIG_SCD4X_CO2_ADAPTIVE_THRESHOLD)
+    {
+        return true;
+    }
+#endif
+    return false;
+}
+
+/**
+ * @brief Save the SCD4X temperature and humidity if there is no other source for them
+ *
+ */
+static void save_scd4x_rht(void)
+{
+#ifndef CONFIG_ENABLE_SHT4X
+    set_value(TEMPERATURE, sensor_value_to_float(&temperature_2));
+    set_value(HUMIDITY, sensor_value_to_float(&humidity_2));
+#endif
+    LOG_INF("SCD4X temperature: %d.%d °C", temperature_2.val1, temperature_2.val2);
+    LOG_INF("SCD4X humidity: %d.%d %%RH", humidity_2.val1, humidity_2.val2);
+}
+
+#ifndef CONFIG_ENABLE_SHT4X
+/**
+ * @brief Do a RH/T only measurement with the SCD4X and save the temperature and humidity to the variables
  *
  * @return int, 0 if ok, non-zero if an error occured
  */
-static int read_scd4x_data()
+static int read_scd4x_rht_data()
 {
     int rc = 0;
+    rc = sensor_sample_fetch_chan(scd4x_dev_p, SENSOR_CHAN_AMBIENT_TEMP);
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to fetch RH/T sample from SCD4x device (err %d).", rc);
+        set_value(TEMPERATURE, -1.0f); // Error indicator
+        set_value(HUMIDITY, -1.0f);    // Error indicator
+        return rc;
+    }
 
-#ifdef CONFIG_ENABLE_BMP390
-    rc = sensor_attr_set(scd4x_dev_p, SENSOR_CHAN_CO2, SENSOR_ATTR_SCD4X_AMBIENT_PRESSURE, &pressure);
+    rc = sensor_channel_get(scd4x_dev_p, SENSOR_CHAN_AMBIENT_TEMP, &temperature_2);
+    if (rc == 0)
+    {
+        rc = sensor_channel_get(scd4x_dev_p, SENSOR_CHAN_HUMIDITY, &humidity_2);
+    }
     if (rc != 0)
     {
-        LOG_ERR("Failed to set pressure compensation (err %d).", rc);
+        LOG_ERR("Failed to get RH/T data (err %d).", rc);
+        set_value(TEMPERATURE, -1.0f); // Error indicator
+        set_value(HUMIDITY, -1.0f);    // Error indicator
+        return rc;
+    }
+
+    save_scd4x_rht();
+    return 0;
+}
+#endif
+
+/**
+ * @brief Power up the SCD4X and start a full or RH/T only single shot, depending on the CO2 schedule
+ *
+ * @param ready_in_ms Output for the time until the measurement is ready
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int start_scd4x(uint32_t *ready_in_ms)
+{
+    int rc = 0;
+
+    co2_measuring = scd4x_co2_due();
+#ifdef CONFIG_ENABLE_SHT4X
+    if (!co2_measuring)
+    {
+        // Nothing to measure, keep the sensor powered down
+        return 0;
+    }
+#endif
+
+    rc = power_up_sensor(scd4x_dev_p);
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to activate SCD4X device (err %d).", rc);
+        set_value(CO2_CONCENTRATION, -1.0f); // Error indicator
+        return rc;
+    }
+
+#ifdef CONFIG_ENABLE_BMP390
+    if (co2_measuring)
+    {
+        rc = sensor_attr_set(scd4x_dev_p, SENSOR_CHAN_CO2, SENSOR_ATTR_SCD4X_AMBIENT_PRESSURE, &pressure);
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to set pressure compensation (err %d).", rc);
+            set_value(CO2_CONCENTRATION, -1.0f); // Error indicator
+            return rc;
+        }
+    }
+#endif
+
+    rc = scd4x_start_single_shot(scd4x_dev_p, co2_measuring ? SENSOR_CHAN_CO2 : SENSOR_CHAN_AMBIENT_TEMP, ready_in_ms);
+    if (rc == -ENOTSUP)
+    {
+        // Periodic measurement mode, the latest measurement can be read after the warm-up
+        *ready_in_ms = 0;
+    }
+    else if (rc != 0)
+    {
+        LOG_ERR("Failed to start SCD4X measurement (err %d).", rc);
         set_value(CO2_CONCENTRATION, -1.0f); // Error indicator
         return rc;
     }
+    *ready_in_ms += CONFIG_SCD4X_WARMUP_TIME_MS;
+    return 0;
+}
+
+/**
+ * @brief Read SCD4X sensor data and save the temperature, humidity and CO2 levels to the variables
+ *
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int read_scd4x_data()
+{
+    int rc = 0;
+
+    if (!co2_measuring)
+    {
+        cycles_since_co2++;
+
+        // Repeat the latest full measurement to keep the CO2 buffer consistent
+        set_value(CO2_CONCENTRATION, latest_co2);
+        LOG_INF("SCD4X CO2 measurement not due (%d/%d), skipping.", cycles_since_co2, CONFIG_SCD4X_CO2_MEASUREMENT_INTERVAL);
+#ifdef CONFIG_ENABLE_SHT4X
+        return 0;
+#else
+        return read_scd4x_rht_data();
 #endif
+    }
+    cycles_since_co2 = 1;
+    previous_co2 = latest_co2;
+    latest_co2 = -1.0f;
 
     rc = sensor_sample_fetch(scd4x_dev_p);
     if (rc != 0)
@@ -315,121 +778,411 @@ static int read_scd4x_data()
     }
 
     // Save values
-    set_value(CO2_CONCENTRATION, sensor_value_to_float(&co2_concentration));
+    latest_co2 = sensor_value_to_float(&co2_concentration);
+    set_value(CO2_CONCENTRATION, latest_co2);
     LOG_INF("SCD4X CO2 concentration: %d.%d ppm", co2_concentration.val1, co2_concentration.val2);
-    LOG_INF("SCD4X temperature: %d.%d °C", temperature_2.val1, temperature_2.val2);
-    LOG_INF("SCD4X humidity: %d.%d %%RH", humidity_2.val1, humidity_2.val2);
+    save_scd4x_rht();
     return 0;
 }
 #endif
 
-int read_sensors(void)
+#ifdef CONFIG_ENABLE_SHT4X
+static uint32_t lead_time_sht4x(void)
 {
-    int rc = 0;
-    int success = true;
+    return CONFIG_SHT4X_WARMUP_TIME_MS;
+}
+#endif
 
+#ifdef CONFIG_ENABLE_SCD4X
+static uint32_t lead_time_scd4x(void)
+{
+    bool co2_due = scd4x_co2_due();
 #ifdef CONFIG_ENABLE_SHT4X
-    rc = read_sht4x_data();
-    if (rc != 0)
+    if (!co2_due)
     {
-        LOG_ERR("Failed to read SHT4X data (err %d).", rc);
-        success = false;
+        return 0;
     }
+#endif
+    return CONFIG_SCD4X_WARMUP_TIME_MS + (co2_due ? SCD4X_SINGLE_SHOT_TIME_MS : SCD4X_SINGLE_SHOT_RHT_ONLY_TIME_MS);
+}
 #endif
 
 #ifdef CONFIG_ENABLE_BMP390
-    rc = read_bmp390_data();
-    if (rc != 0)
-    {
-        LOG_ERR("Failed to read BMP390 data (err %d).", rc);
-        success = false;
-    }
+static uint32_t lead_time_bmp390(void)
+{
+#ifdef CONFIG_ENABLE_SCD4X
+    // The pressure is needed for the SCD4X compensation, so it is read before the SCD4X measurement starts
+    return lead_time_scd4x() + CONFIG_BMP390_WARMUP_TIME_MS;
+#else
+    return CONFIG_BMP390_WARMUP_TIME_MS;
+#endif
+}
 #endif
 
+#if defined(CONFIG_ENABLE_SGP40) && !defined(CONFIG_SGP40_LOW_POWER_MODE)
+static uint32_t lead_time_sgp40(void)
+{
+    return CONFIG_SGP40_WARMUP_TIME_MS;
+}
+#endif
+
+/**
+ * @brief Measurement schedule entry of a sensor
+ *
+ */
+typedef struct
+{
+    const char *name;
+    const struct device **dev;
+    // Predicted time from power up until the sensor can be read
+    uint32_t (*lead_time_ms)(void);
+    // Power up the sensor and start the measurement, outputs the time until it is ready
+    int (*start)(uint32_t *ready_in_ms);
+    // Finish the measurement and save the values
+    int (*read)(void);
+    // Sensor that has to be read before this one is started, NULL if none
+    const struct device **wait_for;
+    int64_t start_at_ms;
+    int64_t ready_at_ms;
+    bool scheduled;
+    bool pending;
+    bool trigger;
+} scheduled_sensor_t;
+
+/**
+ * @brief Sensors in the order they are started and read when due at the same time. Sensors that are ready right
+ * away are read before starting the next one, so their values can be used to compensate the ones started later.
+ *
+ */
+static scheduled_sensor_t scheduled_sensors[] = {
+#ifdef CONFIG_ENABLE_SHT4X
+    {.name = "SHT4X", .dev = &sht4x_dev_p, .lead_time_ms = lead_time_sht4x, .start = start_sht4x, .read = read_sht4x_data},
+#endif
+#ifdef CONFIG_ENABLE_BMP390
+    {.name = "BMP390", .dev = &bmp390_dev_p, .lead_time_ms = lead_time_bmp390, .start = start_bmp390, .read = read_bmp390_data},
+#endif
 #ifdef CONFIG_ENABLE_SCD4X
-    rc = read_scd4x_data();
-    if (rc != 0)
-    {
-        LOG_ERR("Failed to read SCD4X data (err %d).", rc);
-        success = false;
-    }
+#ifdef CONFIG_ENABLE_BMP390
+    {.name = "SCD4X", .dev = &scd4x_dev_p, .lead_time_ms = lead_time_scd4x, .start = start_scd4x, .read = read_scd4x_data,
+     .wait_for = &bmp390_dev_p},
+#else
+    {.name = "SCD4X", .dev = &scd4x_dev_p, .lead_time_ms = lead_time_scd4x, .start = start_scd4x, .read = read_scd4x_data},
 #endif
+#endif
+#if defined(CONFIG_ENABLE_SGP40) && !defined(CONFIG_SGP40_LOW_POWER_MODE)
+    {.name = "SGP40", .dev = &sgp40_dev_p, .lead_time_ms = lead_time_sgp40, .start = start_sgp40, .read = read_sgp40_data},
+#endif
+};
 
-#ifdef CONFIG_ENABLE_SGP40
-    rc = read_sgp40_data();
-    if (rc != 0)
+static const struct sensor_trigger data_ready_trigger = {
+    .type = SENSOR_TRIG_DATA_READY,
+    .chan = SENSOR_CHAN_ALL,
+};
+static atomic_t sensor_ready_flags;
+static K_SEM_DEFINE(sensor_ready_sem, 0, 1);
+
+/**
+ * @brief Data ready trigger handler, marks the sensor ready ahead of its predicted ready time
+ *
+ * @param dev Sensor device
+ * @param trigger Trigger that fired
+ */
+static void sensor_data_ready_handler(const struct device *dev, const struct sensor_trigger *trigger)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(scheduled_sensors); i++)
     {
-        LOG_ERR("Failed to read SGP40 data (err %d).", rc);
-        success = false;
+        if (*scheduled_sensors[i].dev == dev)
+        {
+            atomic_set_bit(&sensor_ready_flags, i);
+        }
     }
-#endif
-    return success ? 0 : -ENXIO;
+    k_sem_give(&sensor_ready_sem);
 }
 
-int activate_sensors(void)
+/**
+ * @brief Check if a sensor has to wait for another sensor to be read before it is started
+ *
+ * @param sensor Sensor to check
+ * @return true if the sensor it waits for is still to be started or read, false otherwise
+ */
+static bool is_waiting(const scheduled_sensor_t *sensor)
 {
-    LOG_INF("Activating sensors");
-    int rc, ret = 0;
-#ifdef CONFIG_ENABLE_SGP40
-    rc = pm_device_action_run(sgp40_dev_p, PM_DEVICE_ACTION_RESUME);
-    if (rc != 0)
+    if (sensor->wait_for == NULL)
     {
-        LOG_ERR("Failed to activate SGP40 device (err %d).", rc);
-        ret = rc;
+        return false;
     }
-    rc = warm_up_sgp40();
-    if (rc != 0)
+    for (size_t i = 0; i < ARRAY_SIZE(scheduled_sensors); i++)
     {
-        LOG_ERR("Failed to do a warmup measurement on the SGP40 (err %d).", rc);
-        ret = rc;
+        const scheduled_sensor_t *other = &scheduled_sensors[i];
+        if (*other->dev == *sensor->wait_for && (other->scheduled || other->pending))
+        {
+            return true;
+        }
     }
-#endif
-#ifdef CONFIG_ENABLE_BMP390
-    rc = pm_device_action_run(bmp390_dev_p, PM_DEVICE_ACTION_RESUME);
+    return false;
+}
+
+/**
+ * @brief Start a sensor measurement and schedule the read
+ *
+ * @param sensor Sensor to start
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int start_scheduled_sensor(scheduled_sensor_t *sensor)
+{
+    int rc = 0;
+    uint32_t ready_in_ms = 0;
+
+    sensor->scheduled = false;
+    rc = sensor->start(&ready_in_ms);
     if (rc != 0)
     {
-        LOG_ERR("Failed to activate BMP390 device (err %d).", rc);
-        ret = rc;
+        power_down_sensor(*sensor->dev);
+        return rc;
     }
-#endif
-#ifdef CONFIG_ENABLE_SCD4X
-    rc = pm_device_action_run(scd4x_dev_p, PM_DEVICE_ACTION_RESUME);
-    if (rc != 0)
+
+    // Sensors with a data ready trigger may signal readiness before the predicted time
+    sensor->trigger = ready_in_ms > 0 &&
+                      sensor_trigger_set(*sensor->dev, &data_ready_trigger, sensor_data_ready_handler) == 0;
+    sensor->ready_at_ms = k_uptime_get() + ready_in_ms;
+    sensor->pending = true;
+    LOG_DBG("%s started, ready in %u ms.", sensor->name, ready_in_ms);
+    return 0;
+}
+
+/**
+ * @brief Read each pending sensor that is ready and power it down right away
+ *
+ * @return int, 0 if ok, non-zero if an error occured during any of the reads
+ */
+static int read_ready_sensors(void)
+{
+    int rc, ret = 0;
+    int64_t now = k_uptime_get();
+
+    for (size_t i = 0; i < ARRAY_SIZE(scheduled_sensors); i++)
     {
-        LOG_ERR("Failed to activate SCD4X device (err %d).", rc);
-        ret = rc;
+        scheduled_sensor_t *sensor = &scheduled_sensors[i];
+        bool triggered = atomic_test_and_clear_bit(&sensor_ready_flags, i);
+        if (!sensor->pending || (!triggered && now < sensor->ready_at_ms))
+        {
+            continue;
+        }
+        sensor->pending = false;
+        if (sensor->trigger)
+        {
+            sensor_trigger_set(*sensor->dev, &data_ready_trigger, NULL);
+        }
+
+        rc = sensor->read();
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to read %s data (err %d).", sensor->name, rc);
+            ret = rc;
+        }
+        rc = power_down_sensor(*sensor->dev);
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to suspend %s device (err %d).", sensor->name, rc);
+            ret = rc;
+        }
     }
-#endif
     return ret;
 }
 
-int suspend_sensors(void)
+/**
+ * @brief Start the sensors whose start time has come and read the ones that are ready
+ *
+ * @return int, 0 if ok, non-zero if an error occured
+ */
+static int run_due_sensors(void)
 {
-    LOG_INF("Suspending sensors.");
     int rc, ret = 0;
-#ifdef CONFIG_ENABLE_SGP40
-    rc = pm_device_action_run(sgp40_dev_p, PM_DEVICE_ACTION_SUSPEND);
-    if (rc != 0)
+
+    for (size_t i = 0; i < ARRAY_SIZE(scheduled_sensors); i++)
     {
-        LOG_ERR("Failed to suspend SGP40 device (err %d).", rc);
-        ret = rc;
+        scheduled_sensor_t *sensor = &scheduled_sensors[i];
+        // A sensor started late still has to be read before the sensors waiting for it start
+        if (!sensor->scheduled || k_uptime_get() < sensor->start_at_ms || is_waiting(sensor))
+        {
+            continue;
+        }
+        rc = start_scheduled_sensor(sensor);
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to start %s measurement (err %d).", sensor->name, rc);
+            ret = rc;
+        }
+        // Read the sensors that are ready right away before starting the next one
+        rc = read_ready_sensors();
+        if (rc != 0)
+        {
+            ret = rc;
+        }
     }
-#endif
-#ifdef CONFIG_ENABLE_BMP390
-    rc = pm_device_action_run(bmp390_dev_p, PM_DEVICE_ACTION_SUSPEND);
-    if (rc != 0)
+
+    rc = read_ready_sensors();
+    return rc != 0 ? rc : ret;
+}
+
+/**
+ * @brief Get the time of the next sensor start or predicted ready time
+ *
+ * @param event_at_ms Output for the event time
+ * @return true if there are sensors left to start or read, false otherwise
+ */
+static bool next_event_time(int64_t *event_at_ms)
+{
+    bool found = false;
+    for (size_t i = 0; i < ARRAY_SIZE(scheduled_sensors); i++)
+    {
+        const scheduled_sensor_t *sensor = &scheduled_sensors[i];
+        int64_t event_ms;
+        if (sensor->scheduled && is_waiting(sensor))
+        {
+            // Started once the sensor it waits for was read, which is an event of its own
+            continue;
+        }
+        else if (sensor->scheduled)
+        {
+            event_ms = sensor->start_at_ms;
+        }
+        else if (sensor->pending)
+        {
+            event_ms = sensor->ready_at_ms;
+        }
+        else
+        {
+            continue;
+        }
+        if (!found || event_ms < *event_at_ms)
+        {
+            *event_at_ms = event_ms;
+            found = true;
+        }
+    }
+    return found;
+}
+
+int read_sensors(void)
+{
+    int rc = 0;
+    int success = true;
+
+    // Power each sensor up just in time for all of them to be ready at the same read instant
+    uint32_t max_lead_time_ms = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(scheduled_sensors); i++)
     {
-        LOG_ERR("Failed to suspend BMP390 device (err %d).", rc);
-        ret = rc;
+        uint32_t lead_time_ms = scheduled_sensors[i].lead_time_ms();
+        max_lead_time_ms = MAX(max_lead_time_ms, lead_time_ms);
+        scheduled_sensors[i].start_at_ms = -(int64_t)lead_time_ms;
+    }
+    int64_t read_at_ms = k_uptime_get() + max_lead_time_ms;
+    for (size_t i = 0; i < ARRAY_SIZE(scheduled_sensors); i++)
+    {
+        scheduled_sensors[i].start_at_ms += read_at_ms;
+        scheduled_sensors[i].scheduled = true;
+    }
+    LOG_INF("Sensors will be read in %u ms.", max_lead_time_ms);
+
+    int64_t event_at_ms;
+    while (next_event_time(&event_at_ms))
+    {
+        k_sem_take(&sensor_ready_sem, K_TIMEOUT_ABS_MS(event_at_ms));
+        rc = run_due_sensors();
+        if (rc != 0)
+        {
+            success = false;
+        }
+    }
+
+#if defined(CONFIG_ENABLE_SGP40) && defined(CONFIG_SGP40_LOW_POWER_MODE)
+    // The SGP40 runs its own duty cycle, save its latest VOC index
+    k_spinlock_key_t key = k_spin_lock(&compensation_lock);
+    float voc = latest_voc_index;
+    k_spin_unlock(&compensation_lock, key);
+    set_value(VOC_INDEX, voc);
+    if (voc < 0)
+    {
+        LOG_ERR("No valid SGP40 VOC index available.");
+        success = false;
     }
 #endif
+
 #ifdef CONFIG_ENABLE_SCD4X
-    rc = pm_device_action_run(scd4x_dev_p, PM_DEVICE_ACTION_SUSPEND);
-    if (rc != 0)
+    scd4x_bus_stats_t scd4x_stats;
+    scd4x_get_bus_stats(scd4x_dev_p, &scd4x_stats);
+    LOG_DBG("SCD4X attribute writes issued: %u, elided: %u", scd4x_stats.issued, scd4x_stats.elided);
+#endif
+#ifdef CONFIG_ENABLE_BMP390
+    bmp390_bus_stats_t bmp390_stats;
+    bmp390_get_bus_stats(bmp390_dev_p, &bmp390_stats);
+    LOG_DBG("BMP390 register writes issued: %u, elided: %u", bmp390_stats.issued, bmp390_stats.elided);
+#endif
+    return success ? 0 : -ENXIO;
+}
+
+int save_sensors_state(void)
+{
+#if defined(CONFIG_ENABLE_SGP40) && defined(CONFIG_GAS_INDEX_PERSIST_STATE)
+    float state0, state1;
+    get_voc_algorithm_states(&state0, &state1);
+    LOG_INF("Saving gas index states.");
+    return save_gas_index_state(state0, state1);
+#else
+    return 0;
+#endif
+}
+
+int stop_voc_sampling(void)
+{
+#if defined(CONFIG_ENABLE_SGP40) && defined(CONFIG_SGP40_LOW_POWER_MODE)
+    struct k_work_sync sync;
+    // Waits for a running burst step, the duty cycle cannot reschedule itself while it is cancelled
+    k_work_cancel_delayable_sync(&sgp40_duty_cycle_work, &sync);
+    if (sgp40_burst_count > 0)
     {
-        LOG_ERR("Failed to suspend SCD4X device (err %d).", rc);
-        ret = rc;
+        end_sgp40_burst();
     }
+    LOG_INF("SGP40 duty cycle stopped.");
 #endif
+    return 0;
+}
+
+int activate_sensors(void)
+{
+    LOG_INF("Activating sensors");
+    // The sensors are powered up one by one when the measurement is started
+    for (size_t i = 0; i < ARRAY_SIZE(scheduled_sensors); i++)
+    {
+        scheduled_sensors[i].scheduled = false;
+        scheduled_sensors[i].pending = false;
+    }
+    atomic_clear(&sensor_ready_flags);
+    k_sem_reset(&sensor_ready_sem);
+    return 0;
+}
+
+int suspend_sensors(void)
+{
+    LOG_INF("Suspending sensors.");
+    int rc, ret = 0;
+    for (size_t i = 0; i < ARRAY_SIZE(scheduled_sensors); i++)
+    {
+        scheduled_sensor_t *sensor = &scheduled_sensors[i];
+        if (sensor->pending && sensor->trigger)
+        {
+            sensor_trigger_set(*sensor->dev, &data_ready_trigger, NULL);
+        }
+        sensor->scheduled = false;
+        sensor->pending = false;
+
+        rc = power_down_sensor(*sensor->dev);
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to suspend %s device (err %d).", sensor->name, rc);
+            ret = rc;
+        }
+    }
     return ret;
-}
\ No newline at end of file
+}
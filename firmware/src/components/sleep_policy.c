@@ -0,0 +1,37 @@
+#include <components/sleep_policy.h>
+#include <components/bluetooth_handler.h>
+
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(sleep_policy);
+
+sleep_level_t select_sleep_level(int64_t gap_ms)
+{
+#ifdef CONFIG_SLEEP_POLICY
+    // Disabling the controller only pays off if the gap is long compared to enabling it again
+    if (gap_ms >= CONFIG_SLEEP_RADIO_OFF_MIN_GAP)
+    {
+        return SLEEP_RADIO_OFF;
+    }
+#endif
+    return SLEEP_KERNEL_IDLE;
+}
+
+int enter_sleep(int64_t gap_ms)
+{
+    int rc = 0;
+    sleep_level_t level = select_sleep_level(gap_ms);
+    LOG_DBG("Sleeping %lld ms at level %d.", gap_ms, level);
+
+    // Sensors, display and flash are already suspended when leaving their states, nothing to do for kernel idle
+    if (level >= SLEEP_RADIO_OFF)
+    {
+        rc = suspend_ble();
+        if (rc != 0)
+        {
+            LOG_WRN("Radio not suspended, idling with the controller on (err %d).", rc);
+            return rc;
+        }
+    }
+    return rc;
+}
@@ -1,9 +1,13 @@
 #include <components/state_manager.h>
-#include <components/flash_manager.h>
+#include <components/power_manager.h>
 #include <components/sensors.h>
 #include <components/e_paper_display.h>
 
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
 
 LOG_MODULE_REGISTER(state_manager);
 
@@ -17,70 +21,181 @@ typedef struct
 
 typedef struct
 {
+    const power_domain_t *domains;
+    size_t count;
+} domain_array_t;
+
+typedef struct
+{
+    const domain_array_t power;
     const action_array_t on_enter;
     const action_array_t on_exit;
 } state_actions_t;
 
-// For each state, definitions of actions to take on entering and exiting the state
+// For each state, definitions of the peripherals held in the state and actions to take on entering and exiting it.
+// Peripherals of the next state are acquired before the ones of the previous state are released, so a peripheral
+// used by both stays powered. A peripheral not held by any state is suspended.
 
-// By default suspend everything at the end
+// Enabling runtime power management suspends the sensors at init, make sure none is left powered until measuring
+power_domain_t initialize_power[] = {};
 action_fn_t initialize_enter[] = {};
-action_fn_t initialize_exit[] = {suspend_flash, suspend_sensors, suspend_epd};
+action_fn_t initialize_exit[] = {suspend_sensors};
 state_actions_t initialize_actions = {
+    .power = {.domains = initialize_power, .count = sizeof(initialize_power) / sizeof(initialize_power[0])},
     .on_enter = {.actions = initialize_enter, .count = sizeof(initialize_enter) / sizeof(initialize_enter[0])},
     .on_exit = {.actions = initialize_exit, .count = sizeof(initialize_exit) / sizeof(initialize_exit[0])},
 };
 
-// By default suspend everything at the end
-action_fn_t startup_enter[] = {activate_epd};
-action_fn_t startup_exit[] = {suspend_epd};
+// The display acquires the EPD by itself for each refresh
+power_domain_t startup_power[] = {};
+action_fn_t startup_enter[] = {};
+action_fn_t startup_exit[] = {};
 state_actions_t startup_actions = {
+    .power = {.domains = startup_power, .count = sizeof(startup_power) / sizeof(startup_power[0])},
     .on_enter = {.actions = startup_enter, .count = sizeof(startup_enter) / sizeof(startup_enter[0])},
     .on_exit = {.actions = startup_exit, .count = sizeof(startup_exit) / sizeof(startup_exit[0])},
 };
 
-// Activate sensors and suspend when done
-action_fn_t measuring_enter[] = {activate_sensors};
-action_fn_t measuring_exit[] = {suspend_sensors};
+// Hold the sensors while measuring
+power_domain_t measuring_power[] = {POWER_SENSORS};
+action_fn_t measuring_enter[] = {};
+action_fn_t measuring_exit[] = {};
 state_actions_t measuring_actions = {
+    .power = {.domains = measuring_power, .count = sizeof(measuring_power) / sizeof(measuring_power[0])},
     .on_enter = {.actions = measuring_enter, .count = sizeof(measuring_enter) / sizeof(measuring_enter[0])},
     .on_exit = {.actions = measuring_exit, .count = sizeof(measuring_exit) / sizeof(measuring_exit[0])},
 };
 
-// Activate e paper display and suspend when done
-action_fn_t updating_enter[] = {activate_epd};
-action_fn_t updating_exit[] = {suspend_epd};
+// The display acquires the EPD by itself only if something visible changed
+power_domain_t updating_power[] = {};
+action_fn_t updating_enter[] = {};
+action_fn_t updating_exit[] = {};
 state_actions_t updating_actions = {
+    .power = {.domains = updating_power, .count = sizeof(updating_power) / sizeof(updating_power[0])},
     .on_enter = {.actions = updating_enter, .count = sizeof(updating_enter) / sizeof(updating_enter[0])},
     .on_exit = {.actions = updating_exit, .count = sizeof(updating_exit) / sizeof(updating_exit[0])},
 };
 
-// Nothing to activate or suspend
+// Nothing to hold
+power_domain_t advertising_power[] = {};
 action_fn_t advertising_enter[] = {};
 action_fn_t advertising_exit[] = {};
 state_actions_t advertising_actions = {
+    .power = {.domains = advertising_power, .count = sizeof(advertising_power) / sizeof(advertising_power[0])},
     .on_enter = {.actions = advertising_enter, .count = sizeof(advertising_enter) / sizeof(advertising_enter[0])},
     .on_exit = {.actions = advertising_exit, .count = sizeof(advertising_exit) / sizeof(advertising_exit[0])},
 };
 
-// Suspend peripherals and activate on exit
+// Nothing to hold
+power_domain_t idle_power[] = {};
 action_fn_t idle_enter[] = {};
 action_fn_t idle_exit[] = {};
 state_actions_t idle_actions = {
+    .power = {.domains = idle_power, .count = sizeof(idle_power) / sizeof(idle_power[0])},
     .on_enter = {.actions = idle_enter, .count = sizeof(idle_enter) / sizeof(idle_enter[0])},
     .on_exit = {.actions = idle_exit, .count = sizeof(idle_exit) / sizeof(idle_exit[0])},
 };
 
-// Suspend everything on error, no recovery
-action_fn_t error_enter[] = {suspend_flash, suspend_sensors, suspend_epd};
+// Save the state and hold nothing on error, no recovery
+power_domain_t error_power[] = {};
+action_fn_t error_enter[] = {save_sensors_state, stop_voc_sampling};
 action_fn_t error_exit[] = {};
 state_actions_t error_actions = {
+    .power = {.domains = error_power, .count = sizeof(error_power) / sizeof(error_power[0])},
     .on_enter = {.actions = error_enter, .count = sizeof(error_enter) / sizeof(error_enter[0])},
     .on_exit = {.actions = error_exit, .count = sizeof(error_exit) / sizeof(error_exit[0])},
 };
 
 static state_t current_state = STATE_NOT_SET;
 
+#ifdef CONFIG_STATE_STATS
+#define NUM_STATES (SAMPLING + 1)
+#define UA_MS_PER_UAH (3600 * 1000)
+
+typedef struct
+{
+    uint32_t entries;
+    int64_t total_ms;
+    int64_t max_ms;
+    uint64_t charge_ua_ms;
+} state_record_t;
+
+// Transitions, parallel visits from the display and sensor work queues and readers from the shell and BLE all
+// access the statistics, only under the lock
+static struct k_spinlock stats_lock;
+static state_record_t state_records[NUM_STATES];
+static int64_t state_entered_ms;
+// Time of the current visit covered by parallel states, charged with their current instead
+static int64_t overlapped_ms;
+
+/**
+ * @brief Get the configured mean current draw of a state
+ *
+ * @param state State
+ * @return uint32_t, current in microamperes, 0 for states without an estimate
+ */
+static uint32_t get_state_current(state_t state)
+{
+    switch (state)
+    {
+    case MEASURING:
+        return CONFIG_STATE_CURRENT_MEASURING_UA;
+    case UPDATING:
+        return CONFIG_STATE_CURRENT_UPDATING_UA;
+    case ADVERTISING:
+        return CONFIG_STATE_CURRENT_ADVERTISING_UA;
+    case IDLE:
+        return CONFIG_STATE_CURRENT_IDLE_UA;
+    case SAMPLING:
+        return CONFIG_STATE_CURRENT_SAMPLING_UA;
+    default:
+        return 0;
+    }
+}
+
+/**
+ * @brief Account the time spent in the current state and enter the next one
+ *
+ * @param new_state State being entered
+ */
+static void record_transition(state_t new_state)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    int64_t now_ms = k_uptime_get();
+    int64_t duration_ms = now_ms - state_entered_ms;
+
+    state_record_t *record = &state_records[current_state];
+    record->total_ms += duration_ms;
+    record->max_ms = MAX(record->max_ms, duration_ms);
+    int64_t charged_ms = duration_ms - MIN(overlapped_ms, duration_ms);
+    record->charge_ua_ms += (uint64_t)get_state_current(current_state) * charged_ms;
+
+    state_records[new_state].entries++;
+    state_entered_ms = now_ms;
+    overlapped_ms = 0;
+    current_state = new_state;
+    k_spin_unlock(&stats_lock, key);
+}
+
+void record_parallel_state(state_t state, int64_t duration_ms)
+{
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    state_record_t *record = &state_records[state];
+    record->entries++;
+    record->total_ms += duration_ms;
+    record->max_ms = MAX(record->max_ms, duration_ms);
+    record->charge_ua_ms += (uint64_t)get_state_current(state) * duration_ms;
+
+    // The current of a display refresh is the current of the whole device, not charged twice. The SGP40 heater
+    // current comes on top of the current state.
+    if (state != SAMPLING)
+    {
+        overlapped_ms += duration_ms;
+    }
+    k_spin_unlock(&stats_lock, key);
+}
+#endif // CONFIG_STATE_STATS
+
 static int execute(action_array_t action_arr)
 {
     int rc, ret = 0;
@@ -94,84 +209,72 @@ static int execute(action_array_t action_arr)
     }
     return ret;
 }
+
 /**
- * @brief Setup the state
+ * @brief Acquire the peripherals held in a state
  *
- * @param state State to display
+ * @param power_arr Peripherals of the state
  */
-static int enter_state(state_t state)
+static int acquire(domain_array_t power_arr)
 {
-    int rc = 0;
-    switch (state)
+    int rc, ret = 0;
+    for (int i = 0; i < power_arr.count; i++)
     {
-    case STATE_NOT_SET:
-        break;
-    case INITIALIZING:
-        rc = execute(initialize_actions.on_enter);
-        break;
-    case STARTUP:
-        rc = execute(startup_actions.on_enter);
-        break;
-    case MEASURING:
-        rc = execute(measuring_actions.on_enter);
-        break;
-    case UPDATING:
-        rc = execute(updating_actions.on_enter);
-        break;
-    case ADVERTISING:
-        rc = execute(advertising_actions.on_enter);
-        break;
-    case IDLE:
-        rc = execute(idle_actions.on_enter);
-        break;
-    case ERROR:
-        rc = execute(error_actions.on_enter);
-        break;
-    default:
-        rc = -EINVAL;
-        break;
+        rc = power_get(power_arr.domains[i]);
+        if (rc != 0)
+        {
+            ret = rc;
+        }
     }
-    return rc;
+    return ret;
 }
 
 /**
- * @brief Cleanup the state
+ * @brief Release the peripherals held in a state
  *
- * @param state State to display
+ * @param power_arr Peripherals of the state
  */
-static int exit_state(state_t state)
+static int release(domain_array_t power_arr)
+{
+    int rc, ret = 0;
+    for (int i = 0; i < power_arr.count; i++)
+    {
+        rc = power_put(power_arr.domains[i]);
+        if (rc != 0)
+        {
+            ret = rc;
+        }
+    }
+    return ret;
+}
+
+/**
+ * @brief Get the actions of a state
+ *
+ * @param state State
+ * @return const state_actions_t*, actions of the state or NULL if it has none
+ */
+static const state_actions_t *get_state_actions(state_t state)
 {
-    int rc = 0;
     switch (state)
     {
-    case STATE_NOT_SET:
-        break;
     case INITIALIZING:
-        rc = execute(initialize_actions.on_exit);
-        break;
+        return &initialize_actions;
     case STARTUP:
-        rc = execute(startup_actions.on_exit);
-        break;
+        return &startup_actions;
     case MEASURING:
-        rc = execute(measuring_actions.on_exit);
-        break;
+        return &measuring_actions;
     case UPDATING:
-        rc = execute(updating_actions.on_exit);
-        break;
+        return &updating_actions;
     case ADVERTISING:
-        rc = execute(advertising_actions.on_exit);
-        break;
+        return &advertising_actions;
     case IDLE:
-        rc = execute(idle_actions.on_exit);
-        break;
+        return &idle_actions;
     case ERROR:
-        rc = execute(error_actions.on_exit);
-        break;
+        return &error_actions;
     default:
-        rc = -EINVAL;
-        break;
+        return NULL;
     }
-    return rc;
 }
 
 const char *state_to_string(state_t state)
@@ -194,6 +297,8 @@ const char *state_to_string(state_t state)
         return "IDLE";
     case ERROR:
         return "ERROR";
+    case SAMPLING:
+        return "SAMPLING";
     default:
         return "UNKNOWN_STATE";
     }
@@ -203,20 +308,132 @@ void set_state(state_t new_state)
 {
     LOG_INF("Changing state from %s to %s", state_to_string(current_state), state_to_string(new_state));
     int rc = 0;
-    rc = exit_state(current_state);
-    if (rc != 0)
+    const state_actions_t *old_actions = get_state_actions(current_state);
+    const state_actions_t *new_actions = get_state_actions(new_state);
+    if (old_actions)
     {
-        LOG_ERR("Failed to exit state %s (err %d).", state_to_string(current_state), rc);
+        rc = execute(old_actions->on_exit);
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to exit state %s (err %d).", state_to_string(current_state), rc);
+        }
+    }
+    if (new_actions)
+    {
+        rc = acquire(new_actions->power);
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to power up state %s (err %d).", state_to_string(new_state), rc);
+        }
+    }
+    if (old_actions)
+    {
+        rc = release(old_actions->power);
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to power down state %s (err %d).", state_to_string(current_state), rc);
+        }
     }
-    rc = enter_state(new_state);
-    if (rc != 0)
+    if (new_actions)
     {
-        LOG_ERR("Failed to enter state %s (err %d).", state_to_string(new_state), rc);
+        rc = execute(new_actions->on_enter);
+        if (rc != 0)
+        {
+            LOG_ERR("Failed to enter state %s (err %d).", state_to_string(new_state), rc);
+        }
     }
+#ifdef CONFIG_STATE_STATS
+    record_transition(new_state);
+#else
     current_state = new_state;
+#endif
 }
 
 state_t get_system_state(void)
 {
     return current_state;
-}
\ No newline at end of file
+}
+#ifdef CONFIG_STATE_STATS
+int get_state_stats(state_t state, state_stats_t *stats)
+{
+    if (state >= NUM_STATES)
+    {
+        return -EINVAL;
+    }
+
+    k_spinlock_key_t key = k_spin_lock(&stats_lock);
+    const state_record_t *record = &state_records[state];
+    uint32_t visits = record->entries;
+    int64_t ongoing_ms = 0;
+    int64_t charged_ms = 0;
+
+    // Include the ongoing visit in the totals but not in the per visit figures. STATE_NOT_SET is current before the
+    // first transition without an entry.
+    if (state == current_state)
+    {
+        ongoing_ms = k_uptime_get() - state_entered_ms;
+        charged_ms = ongoing_ms - MIN(overlapped_ms, ongoing_ms);
+        if (visits > 0)
+        {
+            visits--;
+        }
+    }
+
+    stats->entries = record->entries;
+    stats->total_ms = record->total_ms + ongoing_ms;
+    stats->max_ms = record->max_ms;
+    stats->mean_ms = visits > 0 ? record->total_ms / visits : 0;
+    stats->charge_uah = (record->charge_ua_ms + (uint64_t)get_state_current(state) * charged_ms) / UA_MS_PER_UAH;
+    k_spin_unlock(&stats_lock, key);
+    return 0;
+}
+
+uint32_t get_daily_charge_uah(void)
+{
+    uint64_t charge_uah = 0;
+    state_stats_t stats;
+    for (state_t state = STATE_NOT_SET; state < NUM_STATES; state++)
+    {
+        get_state_stats(state, &stats);
+        charge_uah += stats.charge_uah;
+    }
+
+    // Extrapolate the charge consumed since boot to a day
+    int64_t uptime_ms = k_uptime_get();
+    return uptime_ms > 0 ? charge_uah * 24 * 3600 * 1000 / uptime_ms : 0;
+}
+
+#ifdef CONFIG_SHELL
+/**
+ * @brief Shell command printing the time and charge accounted to each state
+ *
+ * @param sh Shell instance
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int, always 0
+ */
+static int cmd_states(const struct shell *sh, size_t argc, char **argv)
+{
+    state_stats_t stats;
+    shell_print(sh, "%-14s %8s %10s %10s %10s %10s", "State", "Entries", "Total (s)", "Mean (ms)", "Max (ms)",
+                "Charge (uAh)");
+    for (state_t state = STATE_NOT_SET; state < NUM_STATES; state++)
+    {
+        get_state_stats(state, &stats);
+        shell_print(sh, "%-14s %8u %10lld %10lld %10lld %10u", state_to_string(state), stats.entries,
+                    stats.total_ms / 1000, stats.mean_ms, stats.max_ms, stats.charge_uah);
+    }
+    shell_print(sh, "Estimated consumption %u uAh per day.", get_daily_charge_uah());
+    // Resumes and suspends done by the power manager
+    shell_print(sh, "%-14s %11s", "Peripheral", "Transitions");
+    for (power_domain_t domain = 0; domain < NUM_POWER_DOMAINS; domain++)
+    {
+        shell_print(sh, "%-14s %11u", power_domain_to_string(domain), get_power_transitions(domain));
+    }
+    return 0;
+}
+
+SHELL_CMD_REGISTER(states, NULL, "Print time and charge accounted to each state and the peripheral power transitions",
+                   cmd_states);
+#endif // CONFIG_SHELL
+#endif // CONFIG_STATE_STATS
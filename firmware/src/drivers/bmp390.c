@@ -13,32 +13,91 @@ static inline int bmp390_read_reg(const struct device *dev, uint8_t start, uint8
     return i2c_burst_read_dt(&cfg->bus, start, buf, size);
 }
 
-static inline int bmp390_write_reg(const struct device *dev, uint8_t reg, uint8_t val)
+static inline bool bmp390_reg_is_shadowed(uint8_t reg)
+{
+    return reg >= BMP390_REG_PWR_CTRL && reg <= BMP390_REG_CONFIG;
+}
+
+static int bmp390_write_reg(const struct device *dev, uint8_t reg, uint8_t val)
 {
     const bmp390_config_t *cfg = dev->config;
-    return i2c_reg_write_byte_dt(&cfg->bus, reg, val);
+    bmp390_data_t *data = dev->data;
+    int rc = 0;
+
+    rc = i2c_reg_write_byte_dt(&cfg->bus, reg, val);
+    if (rc < 0)
+    {
+        if (bmp390_reg_is_shadowed(reg))
+        {
+            data->shadow_valid &= ~BIT(BMP390_SHADOW_IDX(reg));
+        }
+        return rc;
+    }
+    data->writes_issued++;
+
+    if (bmp390_reg_is_shadowed(reg))
+    {
+        data->shadow[BMP390_SHADOW_IDX(reg)] = val;
+        data->shadow_valid |= BIT(BMP390_SHADOW_IDX(reg));
+    }
+
+    return 0;
 }
 
 static int bmp390_reg_field_update(const struct device *dev, uint8_t reg, uint8_t mask, uint8_t val)
 {
+    bmp390_data_t *data = dev->data;
     int rc = 0;
     uint8_t current_value, updated_value;
 
-    rc = bmp390_read_reg(dev, reg, &current_value, 1);
-    if (rc != 0)
+    /* Use the shadow copy instead of reading back configuration registers */
+    if (bmp390_reg_is_shadowed(reg) && (data->shadow_valid & BIT(BMP390_SHADOW_IDX(reg))))
     {
-        return rc;
+        current_value = data->shadow[BMP390_SHADOW_IDX(reg)];
+    }
+    else
+    {
+        rc = bmp390_read_reg(dev, reg, &current_value, 1);
+        if (rc != 0)
+        {
+            return rc;
+        }
     }
 
     updated_value = (current_value & ~mask) | (val & mask);
     if (updated_value == current_value)
     {
+        data->writes_elided++;
         return 0;
     }
 
     return bmp390_write_reg(dev, reg, updated_value);
 }
 
+void bmp390_get_bus_stats(const struct device *dev, bmp390_bus_stats_t *stats)
+{
+    const bmp390_data_t *data = dev->data;
+    stats->issued = data->writes_issued;
+    stats->elided = data->writes_elided;
+}
+
+#ifdef CONFIG_BMP390_FLOAT_COMPENSATION
+static void bmp390_compensate_temp_f(const struct device *dev)
+{
+    /* Adapted from the BMP3_FLOAT_COMPENSATION path of:
+     * https://github.com/BoschSensortec/BMP3-Sensor-API/blob/master/bmp3.c
+     */
+    bmp390_data_t *data = dev->data;
+    bmp390_float_cal_data_t *cal = &data->cal_f;
+
+    float partial_data1 = (float)data->t_sample - cal->t1;
+    float partial_data2 = partial_data1 * cal->t2;
+
+    /* Temperature in degC, stored for pressure calculation */
+    data->comp_temp_f = partial_data2 + (partial_data1 * partial_data1) * cal->t3;
+}
+#endif /* CONFIG_BMP390_FLOAT_COMPENSATION */
+
 static uint32_t get_conversion_time(const struct device *dev)
 {
     const bmp390_config_t *cfg = dev->config;
@@ -67,6 +126,8 @@ static int bmp390_sample_fetch(const struct device *dev, enum sensor_channel cha
         {
             return rc;
         }
+        /* The sensor returns to sleep mode by itself after the conversion */
+        data->shadow[BMP390_SHADOW_IDX(BMP390_REG_PWR_CTRL)] &= ~BMP390_PWR_CTRL_MODE_MASK;
         k_sleep(K_USEC(get_conversion_time(dev)));
     }
     else
@@ -92,10 +153,54 @@ static int bmp390_sample_fetch(const struct device *dev, enum sensor_channel cha
     data->p_sample = sys_get_le24(&raw[0]);
     data->t_sample = sys_get_le24(&raw[3]);
     data->comp_temp = 0;
+#ifdef CONFIG_BMP390_FLOAT_COMPENSATION
+    /* Cheap enough to do right away, pressure compensation needs it anyway */
+    bmp390_compensate_temp_f(dev);
+#endif
 
     return rc;
 }
 
+#ifdef CONFIG_BMP390_FLOAT_COMPENSATION
+static float bmp390_compensate_press_f(const struct device *dev)
+{
+    bmp390_data_t *data = dev->data;
+    bmp390_float_cal_data_t *cal = &data->cal_f;
+
+    float t_lin = data->comp_temp_f;
+    float t_lin2 = t_lin * t_lin;
+    float t_lin3 = t_lin2 * t_lin;
+    float raw_pressure = (float)data->p_sample;
+    float raw_pressure2 = raw_pressure * raw_pressure;
+
+    float offset = cal->p5 + cal->p6 * t_lin + cal->p7 * t_lin2 + cal->p8 * t_lin3;
+    float sensitivity = cal->p1 + cal->p2 * t_lin + cal->p3 * t_lin2 + cal->p4 * t_lin3;
+    float partial_out = raw_pressure2 * (cal->p9 + cal->p10 * t_lin) +
+                        raw_pressure2 * raw_pressure * cal->p11;
+
+    /* returned value is in Pa. */
+    return offset + raw_pressure * sensitivity + partial_out;
+}
+
+static int bmp390_temp_channel_get(const struct device *dev, struct sensor_value *val)
+{
+    bmp390_data_t *data = dev->data;
+
+    return sensor_value_from_float(val, data->comp_temp_f);
+}
+
+static int bmp390_press_channel_get(const struct device *dev, struct sensor_value *val)
+{
+    // Same format as the integer compensation, val2 is in hundredths of Pa. Raw values outside the operating range
+    // can compensate to a negative pressure, which must not reach the unsigned conversion
+    float press = CLAMP(bmp390_compensate_press_f(dev), 0.0f, BMP390_PRESS_MAX_PA);
+    uint32_t tmp = (uint32_t)(press * 100.0f);
+    val->val1 = tmp / 100;
+    val->val2 = tmp % 100;
+
+    return 0;
+}
+#else
 static void bmp390_compensate_temp(const struct device *dev)
 {
     /* Adapted from:
@@ -209,6 +314,7 @@ static int bmp390_press_channel_get(const struct device *dev, struct sensor_valu
 
     return 0;
 }
+#endif /* CONFIG_BMP390_FLOAT_COMPENSATION */
 
 static int bmp390_channel_get(const struct device *dev, enum sensor_channel chan, struct sensor_value *val)
 {
@@ -248,6 +354,25 @@ static int bmp390_get_calibration_data(const struct device *dev)
     cal->p6 = sys_le16_to_cpu(cal->p6);
     cal->p9 = (int16_t)sys_le16_to_cpu(cal->p9);
 
+#ifdef CONFIG_BMP390_FLOAT_COMPENSATION
+    /* Scale the coefficients once, see the BMP390 datasheet section 8.4 */
+    bmp390_float_cal_data_t *cal_f = &data->cal_f;
+    cal_f->t1 = cal->t1 * 0x1p8f;
+    cal_f->t2 = cal->t2 * 0x1p-30f;
+    cal_f->t3 = cal->t3 * 0x1p-48f;
+    cal_f->p1 = (cal->p1 - 16384) * 0x1p-20f;
+    cal_f->p2 = (cal->p2 - 16384) * 0x1p-29f;
+    cal_f->p3 = cal->p3 * 0x1p-32f;
+    cal_f->p4 = cal->p4 * 0x1p-37f;
+    cal_f->p5 = cal->p5 * 0x1p3f;
+    cal_f->p6 = cal->p6 * 0x1p-6f;
+    cal_f->p7 = cal->p7 * 0x1p-8f;
+    cal_f->p8 = cal->p8 * 0x1p-15f;
+    cal_f->p9 = cal->p9 * 0x1p-48f;
+    cal_f->p10 = cal->p10 * 0x1p-48f;
+    cal_f->p11 = cal->p11 * 0x1p-65f;
+#endif
+
     return 0;
 }
 
@@ -263,8 +388,8 @@ static int bmp390_pm_action(const struct device *dev, enum pm_device_action acti
     case PM_DEVICE_ACTION_RESUME:
         if (cfg->mode == BMP390_MODE_FORCED)
         {
-            reg_val = BMP390_PWR_CTRL_MODE_FORCED;
-            break;
+            /* Conversions are triggered on fetch, stay in sleep mode until then */
+            return 0;
         }
         else
         {
@@ -292,6 +417,7 @@ static int bmp390_pm_action(const struct device *dev, enum pm_device_action acti
 static int bmp390_init(const struct device *dev)
 {
     const bmp390_config_t *cfg = dev->config;
+    bmp390_data_t *data = dev->data;
     uint8_t val = 0U;
     int rc = 0;
 
@@ -309,6 +435,7 @@ static int bmp390_init(const struct device *dev)
         return -EIO;
     }
     k_busy_wait(BMP390_START_UP_WAIT_TIME_MS * 1000);
+    data->shadow_valid = 0;
 
     /* Read calibration data */
     rc = bmp390_get_calibration_data(dev);
@@ -0,0 +1,177 @@
+#include <drivers/recording_display.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/sys/printk.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+
+#ifdef CONFIG_RECORDING_DISPLAY
+
+LOG_MODULE_REGISTER(recording_display, CONFIG_DISPLAY_LOG_LEVEL);
+
+#define DUMP_BYTES_PER_LINE 50
+
+typedef struct
+{
+    uint16_t width;
+    uint16_t height;
+    uint8_t *framebuffer; // Vertically tiled, a byte holds 8 rows of one column, topmost row in the MSB
+} recording_display_config_t;
+
+typedef struct
+{
+    bool blanking_on;
+    recording_display_stats_t stats;
+} recording_display_data_t;
+
+/**
+ * @brief Print the panel content after a refresh, read by scripts/display_frames.py
+ *
+ * @param dev Recording display device
+ * @param full True for a full refresh
+ */
+static void dump_frame(const struct device *dev, bool full)
+{
+#ifdef CONFIG_RECORDING_DISPLAY_DUMP_FRAMES
+    const recording_display_config_t *cfg = dev->config;
+    recording_display_data_t *data = dev->data;
+    size_t size = cfg->width * cfg->height / 8;
+
+    printk("FRAME %u %s %u %u\n", data->stats.partial_refreshes + data->stats.full_refreshes,
+           full ? "full" : "partial", cfg->width, cfg->height);
+    for (size_t i = 0; i < size; i++)
+    {
+        printk("%02x", cfg->framebuffer[i]);
+        if ((i + 1) % DUMP_BYTES_PER_LINE == 0 || i + 1 == size)
+        {
+            printk("\n");
+        }
+    }
+    printk("END\n");
+#endif
+}
+
+static int recording_display_blanking_on(const struct device *dev)
+{
+    recording_display_data_t *data = dev->data;
+    data->blanking_on = true;
+    return 0;
+}
+
+static int recording_display_blanking_off(const struct device *dev)
+{
+    recording_display_data_t *data = dev->data;
+    if (data->blanking_on)
+    {
+        data->blanking_on = false;
+        data->stats.full_refreshes++;
+        dump_frame(dev, true);
+    }
+    return 0;
+}
+
+static int recording_display_write(const struct device *dev, const uint16_t x, const uint16_t y,
+                                   const struct display_buffer_descriptor *desc, const void *buf)
+{
+    const recording_display_config_t *cfg = dev->config;
+    recording_display_data_t *data = dev->data;
+
+    // Same constraints as the SSD16xx driver
+    if (desc->pitch != desc->width)
+    {
+        LOG_ERR("Pitch %u differs from width %u.", desc->pitch, desc->width);
+        return -ENOTSUP;
+    }
+    if (y % 8 != 0 || desc->height % 8 != 0)
+    {
+        LOG_ERR("Rows %u-%u are not aligned to pages.", y, y + desc->height - 1);
+        return -EINVAL;
+    }
+    if (x + desc->width > cfg->width || y + desc->height > cfg->height ||
+        desc->buf_size < desc->width * desc->height / 8)
+    {
+        LOG_ERR("Write of %ux%u at %u,%u out of bounds.", desc->width, desc->height, x, y);
+        return -EINVAL;
+    }
+
+    const uint8_t *src = buf;
+    for (int page = 0; page < desc->height / 8; page++)
+    {
+        memcpy(&cfg->framebuffer[(y / 8 + page) * cfg->width + x], &src[page * desc->width], desc->width);
+    }
+
+    data->stats.writes++;
+    data->stats.bytes += desc->width * desc->height / 8;
+    LOG_DBG("Write of %ux%u at %u,%u.", desc->width, desc->height, x, y);
+    if (!data->blanking_on)
+    {
+        data->stats.partial_refreshes++;
+        dump_frame(dev, false);
+    }
+    return 0;
+}
+
+static void recording_display_get_capabilities(const struct device *dev, struct display_capabilities *caps)
+{
+    const recording_display_config_t *cfg = dev->config;
+    memset(caps, 0, sizeof(*caps));
+    caps->x_resolution = cfg->width;
+    caps->y_resolution = cfg->height;
+    caps->supported_pixel_formats = PIXEL_FORMAT_MONO10;
+    caps->current_pixel_format = PIXEL_FORMAT_MONO10;
+    caps->screen_info = SCREEN_INFO_MONO_VTILED | SCREEN_INFO_MONO_MSB_FIRST | SCREEN_INFO_EPD;
+}
+
+static int recording_display_set_pixel_format(const struct device *dev, const enum display_pixel_format format)
+{
+    return format == PIXEL_FORMAT_MONO10 ? 0 : -ENOTSUP;
+}
+
+void recording_display_get_stats(const struct device *dev, recording_display_stats_t *stats)
+{
+    const recording_display_data_t *data = dev->data;
+    *stats = data->stats;
+}
+
+static int recording_display_init(const struct device *dev)
+{
+    const recording_display_config_t *cfg = dev->config;
+    memset(cfg->framebuffer, 0x00, cfg->width * cfg->height / 8);
+    return 0;
+}
+
+static const struct display_driver_api recording_display_api = {
+    .blanking_on = recording_display_blanking_on,
+    .blanking_off = recording_display_blanking_off,
+    .write = recording_display_write,
+    .get_capabilities = recording_display_get_capabilities,
+    .set_pixel_format = recording_display_set_pixel_format,
+};
+
+#define RECORDING_DISPLAY_INST(inst)                                                     \
+    static uint8_t recording_display_framebuffer_##inst[DT_INST_PROP(inst, width) *      \
+                                                        DT_INST_PROP(inst, height) / 8]; \
+    static recording_display_data_t recording_display_data_##inst;                       \
+                                                                                         \
+    static const recording_display_config_t recording_display_config_##inst = {          \
+        .width = DT_INST_PROP(inst, width),                                              \
+        .height = DT_INST_PROP(inst, height),                                            \
+        .framebuffer = recording_display_framebuffer_##inst,                             \
+    };                                                                                   \
+                                                                                         \
+    DEVICE_DT_INST_DEFINE(inst,                                                          \
+                          recording_display_init,                                        \
+                          NULL,                                                          \
+                          &recording_display_data_##inst,                                \
+                          &recording_display_config_##inst,                              \
+                          POST_KERNEL,                                                   \
+                          CONFIG_DISPLAY_INIT_PRIORITY,                                  \
+                          &recording_display_api);
+
+#define DT_DRV_COMPAT recording_display
+DT_INST_FOREACH_STATUS_OKAY(RECORDING_DISPLAY_INST)
+#undef DT_DRV_COMPAT
+
+#endif // CONFIG_RECORDING_DISPLAY
@@ -6,17 +6,92 @@
 #include <zephyr/logging/log.h>
 #include <zephyr/pm/device.h>
 #include <zephyr/sys/byteorder.h>
-#include <zephyr/sys/crc.h>
+
+#include <stdlib.h>
 
 #include <drivers/scd4x.h>
 
 LOG_MODULE_REGISTER(SCD4X, CONFIG_SENSOR_LOG_LEVEL);
 
+/*
+ * CRC-8 lookup table for SCD4X_CRC_POLY, msb first
+ */
+static const uint8_t scd4x_crc_table[256] = {
+    0x00, 0x31, 0x62, 0x53, 0xC4, 0xF5, 0xA6, 0x97, 0xB9, 0x88, 0xDB, 0xEA, 0x7D, 0x4C, 0x1F, 0x2E,
+    0x43, 0x72, 0x21, 0x10, 0x87, 0xB6, 0xE5, 0xD4, 0xFA, 0xCB, 0x98, 0xA9, 0x3E, 0x0F, 0x5C, 0x6D,
+    0x86, 0xB7, 0xE4, 0xD5, 0x42, 0x73, 0x20, 0x11, 0x3F, 0x0E, 0x5D, 0x6C, 0xFB, 0xCA, 0x99, 0xA8,
+    0xC5, 0xF4, 0xA7, 0x96, 0x01, 0x30, 0x63, 0x52, 0x7C, 0x4D, 0x1E, 0x2F, 0xB8, 0x89, 0xDA, 0xEB,
+    0x3D, 0x0C, 0x5F, 0x6E, 0xF9, 0xC8, 0x9B, 0xAA, 0x84, 0xB5, 0xE6, 0xD7, 0x40, 0x71, 0x22, 0x13,
+    0x7E, 0x4F, 0x1C, 0x2D, 0xBA, 0x8B, 0xD8, 0xE9, 0xC7, 0xF6, 0xA5, 0x94, 0x03, 0x32, 0x61, 0x50,
+    0xBB, 0x8A, 0xD9, 0xE8, 0x7F, 0x4E, 0x1D, 0x2C, 0x02, 0x33, 0x60, 0x51, 0xC6, 0xF7, 0xA4, 0x95,
+    0xF8, 0xC9, 0x9A, 0xAB, 0x3C, 0x0D, 0x5E, 0x6F, 0x41, 0x70, 0x23, 0x12, 0x85, 0xB4, 0xE7, 0xD6,
+    0x7A, 0x4B, 0x18, 0x29, 0xBE, 0x8F, 0xDC, 0xED, 0xC3, 0xF2, 0xA1, 0x90, 0x07, 0x36, 0x65, 0x54,
+    0x39, 0x08, 0x5B, 0x6A, 0xFD, 0xCC, 0x9F, 0xAE, 0x80, 0xB1, 0xE2, 0xD3, 0x44, 0x75, 0x26, 0x17,
+    0xFC, 0xCD, 0x9E, 0xAF, 0x38, 0x09, 0x5A, 0x6B, 0x45, 0x74, 0x27, 0x16, 0x81, 0xB0, 0xE3, 0xD2,
+    0xBF, 0x8E, 0xDD, 0xEC, 0x7B, 0x4A, 0x19, 0x28, 0x06, 0x37, 0x64, 0x55, 0xC2, 0xF3, 0xA0, 0x91,
+    0x47, 0x76, 0x25, 0x14, 0x83, 0xB2, 0xE1, 0xD0, 0xFE, 0xCF, 0x9C, 0xAD, 0x3A, 0x0B, 0x58, 0x69,
+    0x04, 0x35, 0x66, 0x57, 0xC0, 0xF1, 0xA2, 0x93, 0xBD, 0x8C, 0xDF, 0xEE, 0x79, 0x48, 0x1B, 0x2A,
+    0xC1, 0xF0, 0xA3, 0x92, 0x05, 0x34, 0x67, 0x56, 0x78, 0x49, 0x1A, 0x2B, 0xBC, 0x8D, 0xDE, 0xEF,
+    0x82, 0xB3, 0xE0, 0xD1, 0x46, 0x77, 0x24, 0x15, 0x3B, 0x0A, 0x59, 0x68, 0xFF, 0xCE, 0x9D, 0xAC,
+};
+
+/*
+ * Maximum command execution times in milliseconds, taken from the
+ * "Overview of SCD4x commands" table of the datasheet.
+ * Commands not listed have no execution time.
+ */
+static const struct
+{
+    uint16_t cmd;
+    uint16_t exec_time_ms;
+} scd4x_exec_times[] = {
+    {SCD4X_CMD_READ_MEASUREMENT, 1},
+    {SCD4X_CMD_STOP_PERIODIC_MEASUREMENT, 500},
+    {SCD4X_CMD_SET_TEMPERATURE_OFFSET, 1},
+    {SCD4X_CMD_GET_TEMPERATURE_OFFSET, 1},
+    {SCD4X_CMD_SET_SENSOR_ALTITUDE, 1},
+    {SCD4X_CMD_GET_SENSOR_ALTITUDE, 1},
+    {SCD4X_CMD_SET_AMBIENT_PRESSURE, 1},
+    {SCD4X_CMD_PERFORM_FORCED_RECALIBRATION, 400},
+    {SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION_ENABLED, 1},
+    {SCD4X_CMD_GET_AUTOMATIC_SELF_CALIBRATION_ENABLED, 1},
+    {SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION_TARGET, 1},
+    {SCD4X_CMD_GET_AUTOMATIC_SELF_CALIBRATION_TARGET, 1},
+    {SCD4X_CMD_GET_DATA_READY_STATUS, 1},
+    {SCD4X_CMD_PERSIST_SETTINGS, 800},
+    {SCD4X_CMD_GET_SERIAL_NUMBER, 1},
+    {SCD4X_CMD_PERFORM_SELF_TEST, 10000},
+    {SCD4X_CMD_PERFORM_FACTORY_RESET, 1200},
+    {SCD4X_CMD_REINIT, 30},
+    {SCD4X_CMD_GET_SENSOR_VARIANT, 1},
+    {SCD4X_CMD_MEASURE_SINGLE_SHOT, SCD4X_SINGLE_SHOT_TIME_MS},
+    {SCD4X_CMD_MEASURE_SINGLE_SHOT_RHT_ONLY, SCD4X_SINGLE_SHOT_RHT_ONLY_TIME_MS},
+    {SCD4X_CMD_POWER_DOWN, 1},
+    {SCD4X_CMD_WAKE_UP, 30},
+    {SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION_INITIAL_PERIOD, 1},
+    {SCD4X_CMD_GET_AUTOMATIC_SELF_CALIBRATION_INITIAL_PERIOD, 1},
+    {SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION_STANDARD_PERIOD, 1},
+    {SCD4X_CMD_GET_AUTOMATIC_SELF_CALIBRATION_STANDARD_PERIOD, 1},
+};
+
+static uint16_t scd4x_exec_time_ms(uint16_t cmd)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(scd4x_exec_times); i++)
+    {
+        if (scd4x_exec_times[i].cmd == cmd)
+        {
+            return scd4x_exec_times[i].exec_time_ms;
+        }
+    }
+    return 0;
+}
+
 static uint8_t scd4x_calc_crc(uint16_t value)
 {
-    uint8_t buf[2];
-    sys_put_be16(value, buf);
-    return crc8(buf, 2, SCD4X_CRC_POLY, SCD4X_CRC_INIT, false);
+    uint8_t crc = SCD4X_CRC_INIT;
+    crc = scd4x_crc_table[crc ^ (uint8_t)(value >> 8)];
+    crc = scd4x_crc_table[crc ^ (uint8_t)value];
+    return crc;
 }
 
 static int scd4x_read_reg(const struct device *dev, uint8_t *rx_buf, uint8_t rx_buf_size)
@@ -24,7 +99,14 @@ static int scd4x_read_reg(const struct device *dev, uint8_t *rx_buf, uint8_t rx_
     const scd4x_config_t *cfg = dev->config;
     int rc = 0;
 
+#ifdef CONFIG_SCD4X_BUS_TIMING
+    scd4x_data_t *data = dev->data;
+    uint32_t start = k_cycle_get_32();
+    rc = i2c_read_dt(&cfg->bus, rx_buf, rx_buf_size);
+    data->bus_cycles += k_cycle_get_32() - start;
+#else
     rc = i2c_read_dt(&cfg->bus, rx_buf, rx_buf_size);
+#endif
     if (rc < 0)
     {
         LOG_ERR("Failed to read i2c data (err %d).", rc);
@@ -59,20 +141,50 @@ static int scd4x_write_reg(const struct device *dev, uint16_t cmd, uint16_t *dat
         tx_buf[tx_buf_pos++] = scd4x_calc_crc(data[i]);
     }
 
+#ifdef CONFIG_SCD4X_BUS_TIMING
+    scd4x_data_t *dev_data = dev->data;
+    uint32_t start = k_cycle_get_32();
+    int rc = i2c_write_dt(&cfg->bus, tx_buf, sizeof(tx_buf));
+    dev_data->bus_cycles += k_cycle_get_32() - start;
+    return rc;
+#else
     return i2c_write_dt(&cfg->bus, tx_buf, sizeof(tx_buf));
+#endif
+}
+
+/*
+ * Write a command and wait for its execution time. Every SCD4X command that returns data
+ * has an execution time, so the protocol does not allow a combined write + read with a
+ * repeated start and the read is always done as a separate transaction after this.
+ */
+static int scd4x_send_cmd(const struct device *dev, uint16_t cmd, uint16_t *data, uint8_t data_size)
+{
+    int rc = 0;
+
+    rc = scd4x_write_reg(dev, cmd, data, data_size);
+    if (rc < 0)
+    {
+        return rc;
+    }
+
+    uint16_t exec_time_ms = scd4x_exec_time_ms(cmd);
+    if (exec_time_ms > 0)
+    {
+        k_sleep(K_MSEC(exec_time_ms));
+    }
+    return 0;
 }
 
 static int scd4x_read_sample(const struct device *dev, uint16_t *co2_sample, uint16_t *t_sample, uint16_t *rh_sample)
 {
     int rc = 0;
 
-    rc = scd4x_write_reg(dev, SCD4X_CMD_READ_MEASUREMENT, NULL, 0);
+    rc = scd4x_send_cmd(dev, SCD4X_CMD_READ_MEASUREMENT, NULL, 0);
     if (rc < 0)
     {
         LOG_ERR("Failed to start measurement (err %d).", rc);
         return rc;
     }
-    k_sleep(K_MSEC(SCD4X_DEFAULT_WAIT_MS));
 
     uint8_t rx_buf[9];
     rc = scd4x_read_reg(dev, rx_buf, sizeof(rx_buf));
@@ -101,23 +213,21 @@ static int scd4x_set_idle_mode(const struct device *dev)
     else if (cfg->mode == SCD4X_MODE_POWER_CYCLED_SINGLE_SHOT)
     {
         /*send wake up command twice because of an expected nack return in power down mode*/
-        rc = scd4x_write_reg(dev, SCD4X_CMD_WAKE_UP, NULL, 0);
+        rc = scd4x_send_cmd(dev, SCD4X_CMD_WAKE_UP, NULL, 0);
         if (rc < 0)
         {
             LOG_ERR("Failed write wake_up command (err %d).", rc);
             return rc;
         }
-        k_sleep(K_MSEC(SCD4X_WAKE_UP_WAIT_MS));
     }
     else
     {
-        rc = scd4x_write_reg(dev, SCD4X_CMD_STOP_PERIODIC_MEASUREMENT, NULL, 0);
+        rc = scd4x_send_cmd(dev, SCD4X_CMD_STOP_PERIODIC_MEASUREMENT, NULL, 0);
         if (rc < 0)
         {
             LOG_ERR("Failed to write stop_periodic_measurement command (err %d).", rc);
             return rc;
         }
-        k_sleep(K_MSEC(SCD4X_STOP_PERIODIC_MEASUREMENT_WAIT_MS));
     }
 
     return 0;
@@ -156,12 +266,39 @@ static int scd4x_setup_measurement(const struct device *dev)
     return 0;
 }
 
+/*
+ * Check the attribute shadow to see if writing the attribute can be skipped.
+ * Ambient pressure changes within the configured tolerance are skipped as well.
+ */
+static bool scd4x_attr_unchanged(const struct device *dev, sensor_attribute_scd4x attr,
+                                 const struct sensor_value *val, uint16_t ticks)
+{
+    const scd4x_config_t *cfg = dev->config;
+    const scd4x_data_t *data = dev->data;
+    uint8_t idx = attr - SENSOR_ATTR_SCD4X_TEMPERATURE_OFFSET;
+
+    if ((data->attr_shadow_valid & BIT(idx)) == 0)
+    {
+        return false;
+    }
+    if (data->attr_shadow[idx] == ticks)
+    {
+        return true;
+    }
+    if (attr == SENSOR_ATTR_SCD4X_AMBIENT_PRESSURE)
+    {
+        return abs(val->val1 - data->ambient_pressure_shadow) <= cfg->ambient_pressure_tolerance;
+    }
+    return false;
+}
+
 static int scd4x_attr_set(const struct device *dev,
                           enum sensor_channel chan,
                           enum sensor_attribute attr,
                           const struct sensor_value *val)
 {
     const scd4x_config_t *cfg = dev->config;
+    scd4x_data_t *data = dev->data;
     int rc = 0;
     bool idle_mode = false;
 
@@ -171,24 +308,13 @@ static int scd4x_attr_set(const struct device *dev,
         return -ENOTSUP;
     }
 
-    // Make sure the sensor is in idle mode when setting anythign else but ambient pressure
-    if ((sensor_attribute_scd4x)attr != SENSOR_ATTR_SCD4X_AMBIENT_PRESSURE)
-    {
-        rc = scd4x_set_idle_mode(dev);
-        if (rc < 0)
-        {
-            LOG_ERR("Failed to set idle mode (err %d).", rc);
-            return rc;
-        }
-        idle_mode = true;
-    }
-
     if (val->val1 < 0 || val->val2 < 0)
     {
         return -EINVAL;
     }
 
     uint16_t ticks;
+    uint16_t cmd;
     switch ((sensor_attribute_scd4x)attr)
     {
     case SENSOR_ATTR_SCD4X_TEMPERATURE_OFFSET:
@@ -197,7 +323,7 @@ static int scd4x_attr_set(const struct device *dev,
             return -EINVAL;
         }
         ticks = (float)(val->val1 + (val->val2 / 1000000.0)) * 0xFFFF / 175;
-        rc = scd4x_write_reg(dev, SCD4X_CMD_SET_TEMPERATURE_OFFSET, &ticks, 1);
+        cmd = SCD4X_CMD_SET_TEMPERATURE_OFFSET;
         break;
 
     case SENSOR_ATTR_SCD4X_ALTITUDE:
@@ -206,7 +332,7 @@ static int scd4x_attr_set(const struct device *dev,
             return -EINVAL;
         }
         ticks = val->val1;
-        rc = scd4x_write_reg(dev, SCD4X_CMD_SET_SENSOR_ALTITUDE, &ticks, 1);
+        cmd = SCD4X_CMD_SET_SENSOR_ALTITUDE;
         break;
 
     case SENSOR_ATTR_SCD4X_AMBIENT_PRESSURE:
@@ -215,7 +341,7 @@ static int scd4x_attr_set(const struct device *dev,
             return -EINVAL;
         }
         ticks = (uint16_t)((float)val->val1 / 100.0f + 0.5f); // round to nearest
-        rc = scd4x_write_reg(dev, SCD4X_CMD_SET_AMBIENT_PRESSURE, &ticks, 1);
+        cmd = SCD4X_CMD_SET_AMBIENT_PRESSURE;
         break;
 
     case SENSOR_ATTR_SCD4X_AUTOMATIC_CALIB_ENABLE:
@@ -225,7 +351,7 @@ static int scd4x_attr_set(const struct device *dev,
         }
 
         ticks = val->val1;
-        rc = scd4x_write_reg(dev, SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION_ENABLED, &ticks, 1);
+        cmd = SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION_ENABLED;
         break;
 
     case SENSOR_ATTR_SCD4X_SELF_CALIB_INITIAL_PERIOD:
@@ -240,7 +366,7 @@ static int scd4x_attr_set(const struct device *dev,
         }
 
         ticks = val->val1;
-        rc = scd4x_write_reg(dev, SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION_INITIAL_PERIOD, &ticks, 1);
+        cmd = SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION_INITIAL_PERIOD;
         break;
 
     case SENSOR_ATTR_SCD4X_SELF_CALIB_STANDARD_PERIOD:
@@ -255,19 +381,47 @@ static int scd4x_attr_set(const struct device *dev,
         }
 
         ticks = val->val1;
-        rc = scd4x_write_reg(dev, SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION_STANDARD_PERIOD, &ticks, 1);
+        cmd = SCD4X_CMD_SET_AUTOMATIC_SELF_CALIBRATION_STANDARD_PERIOD;
         break;
 
     default:
         return -ENOTSUP;
     }
 
+    // Skip the write, and the idle mode switch it would need, if the sensor already has the value
+    if (scd4x_attr_unchanged(dev, (sensor_attribute_scd4x)attr, val, ticks))
+    {
+        data->attr_writes_elided++;
+        return 0;
+    }
+
+    // Make sure the sensor is in idle mode when setting anythign else but ambient pressure
+    if ((sensor_attribute_scd4x)attr != SENSOR_ATTR_SCD4X_AMBIENT_PRESSURE)
+    {
+        rc = scd4x_set_idle_mode(dev);
+        if (rc < 0)
+        {
+            LOG_ERR("Failed to set idle mode (err %d).", rc);
+            return rc;
+        }
+        idle_mode = true;
+    }
+
+    rc = scd4x_send_cmd(dev, cmd, &ticks, 1);
     if (rc < 0)
     {
         LOG_ERR("Failed to set attribute (err %d).", rc);
         return rc;
     }
-    k_sleep(K_MSEC(SCD4X_DEFAULT_WAIT_MS));
+    data->attr_writes_issued++;
+
+    uint8_t idx = attr - SENSOR_ATTR_SCD4X_TEMPERATURE_OFFSET;
+    data->attr_shadow[idx] = ticks;
+    data->attr_shadow_valid |= BIT(idx);
+    if ((sensor_attribute_scd4x)attr == SENSOR_ATTR_SCD4X_AMBIENT_PRESSURE)
+    {
+        data->ambient_pressure_shadow = val->val1;
+    }
 
     if (idle_mode)
     {
@@ -282,6 +436,13 @@ static int scd4x_attr_set(const struct device *dev,
     return 0;
 }
 
+void scd4x_get_bus_stats(const struct device *dev, scd4x_bus_stats_t *stats)
+{
+    const scd4x_data_t *data = dev->data;
+    stats->issued = data->attr_writes_issued;
+    stats->elided = data->attr_writes_elided;
+}
+
 static int scd4x_data_ready(const struct device *dev, bool *is_data_ready)
 {
     uint8_t rx_buf[3];
@@ -289,13 +450,12 @@ static int scd4x_data_ready(const struct device *dev, bool *is_data_ready)
 
     *is_data_ready = false;
 
-    rc = scd4x_write_reg(dev, SCD4X_CMD_GET_DATA_READY_STATUS, NULL, 0);
+    rc = scd4x_send_cmd(dev, SCD4X_CMD_GET_DATA_READY_STATUS, NULL, 0);
     if (rc < 0)
     {
         LOG_ERR("Failed to write get_data_ready_status command (err %d).", rc);
         return rc;
     }
-    k_sleep(K_MSEC(SCD4X_DEFAULT_WAIT_MS));
 
     rc = scd4x_read_reg(dev, rx_buf, sizeof(rx_buf));
     if (rc < 0)
@@ -325,15 +485,47 @@ static int scd4x_sample_fetch(const struct device *dev, enum sensor_channel chan
         return -ENOTSUP;
     }
 
-    if (cfg->mode == SCD4X_MODE_SINGLE_SHOT || cfg->mode == SCD4X_MODE_POWER_CYCLED_SINGLE_SHOT)
+#ifdef CONFIG_SCD4X_BUS_TIMING
+    data->bus_cycles = 0;
+#endif
+
+    uint16_t *co2_sample = &data->co2_sample;
+    uint16_t rht_only_co2_sample;
+    if (data->pending_cmd != 0)
+    {
+        /* Finish the single shot started with scd4x_start_single_shot() */
+        int64_t remaining_ms = data->pending_ready_ms - k_uptime_get();
+        if (remaining_ms > 0)
+        {
+            k_msleep(remaining_ms);
+        }
+        if (data->pending_cmd == SCD4X_CMD_MEASURE_SINGLE_SHOT_RHT_ONLY)
+        {
+            co2_sample = &rht_only_co2_sample;
+        }
+        data->pending_cmd = 0;
+    }
+    else if ((cfg->mode == SCD4X_MODE_SINGLE_SHOT || cfg->mode == SCD4X_MODE_POWER_CYCLED_SINGLE_SHOT) &&
+             (chan == SENSOR_CHAN_AMBIENT_TEMP || chan == SENSOR_CHAN_HUMIDITY))
     {
-        rc = scd4x_write_reg(dev, SCD4X_CMD_MEASURE_SINGLE_SHOT, NULL, 0);
+        /* RH/T only single shot, the CO2 output of this command is always 0 so keep the previous sample */
+        rc = scd4x_send_cmd(dev, SCD4X_CMD_MEASURE_SINGLE_SHOT_RHT_ONLY, NULL, 0);
+        if (rc < 0)
+        {
+            LOG_ERR("Failed to start RH/T only measurement (err %d).", rc);
+            return rc;
+        }
+
+        co2_sample = &rht_only_co2_sample;
+    }
+    else if (cfg->mode == SCD4X_MODE_SINGLE_SHOT || cfg->mode == SCD4X_MODE_POWER_CYCLED_SINGLE_SHOT)
+    {
+        rc = scd4x_send_cmd(dev, SCD4X_CMD_MEASURE_SINGLE_SHOT, NULL, 0);
         if (rc < 0)
         {
             LOG_ERR("Failed to start measurement (err %d).", rc);
             return rc;
         }
-        k_sleep(K_MSEC(SCD4X_MEASURE_SINGLE_SHOT_WAIT_MS));
     }
     else
     {
@@ -351,13 +543,17 @@ static int scd4x_sample_fetch(const struct device *dev, enum sensor_channel chan
         }
     }
 
-    rc = scd4x_read_sample(dev, &data->co2_sample, &data->t_sample, &data->rh_sample);
+    rc = scd4x_read_sample(dev, co2_sample, &data->t_sample, &data->rh_sample);
     if (rc < 0)
     {
         LOG_ERR("Failed to fetch data (err %d).", rc);
         return rc;
     }
 
+#ifdef CONFIG_SCD4X_BUS_TIMING
+    LOG_INF("I2C busy time for the sample: %u us.", k_cyc_to_us_floor32(data->bus_cycles));
+#endif
+
     return 0;
 }
 
@@ -394,6 +590,36 @@ static int scd4x_channel_get(const struct device *dev,
     return 0;
 }
 
+int scd4x_start_single_shot(const struct device *dev, enum sensor_channel chan, uint32_t *ready_in_ms)
+{
+    const scd4x_config_t *cfg = dev->config;
+    scd4x_data_t *data = dev->data;
+    int rc = 0;
+
+    if (cfg->mode != SCD4X_MODE_SINGLE_SHOT && cfg->mode != SCD4X_MODE_POWER_CYCLED_SINGLE_SHOT)
+    {
+        return -ENOTSUP;
+    }
+
+    uint16_t cmd = (chan == SENSOR_CHAN_AMBIENT_TEMP || chan == SENSOR_CHAN_HUMIDITY)
+                       ? SCD4X_CMD_MEASURE_SINGLE_SHOT_RHT_ONLY
+                       : SCD4X_CMD_MEASURE_SINGLE_SHOT;
+
+    /* Only issue the command, the wait is done in the fetch */
+    rc = scd4x_write_reg(dev, cmd, NULL, 0);
+    if (rc < 0)
+    {
+        LOG_ERR("Failed to start single shot measurement (err %d).", rc);
+        return rc;
+    }
+
+    *ready_in_ms = scd4x_exec_time_ms(cmd);
+    data->pending_ready_ms = k_uptime_get() + *ready_in_ms;
+    data->pending_cmd = cmd;
+
+    return 0;
+}
+
 int scd4x_forced_recalibration(const struct device *dev, uint16_t target_concentration_ticks,
                                uint16_t *frc_correction)
 {
@@ -407,13 +633,12 @@ int scd4x_forced_recalibration(const struct device *dev, uint16_t target_concent
         return rc;
     }
 
-    rc = scd4x_write_reg(dev, SCD4X_CMD_PERFORM_FORCED_RECALIBRATION, &target_concentration_ticks, 1);
+    rc = scd4x_send_cmd(dev, SCD4X_CMD_PERFORM_FORCED_RECALIBRATION, &target_concentration_ticks, 1);
     if (rc < 0)
     {
         LOG_ERR("Failed to write perform_forced_recalibration register (err %d).", rc);
         return rc;
     }
-    k_sleep(K_MSEC(SCD4X_FORCED_CALIBRATION_WAIT_MS));
 
     rc = scd4x_read_reg(dev, rx_buf, sizeof(rx_buf));
     if (rc < 0)
@@ -454,13 +679,13 @@ int scd4x_factory_reset(const struct device *dev)
         return rc;
     }
 
-    rc = scd4x_write_reg(dev, SCD4X_CMD_PERFORM_FACTORY_RESET, NULL, 0);
+    rc = scd4x_send_cmd(dev, SCD4X_CMD_PERFORM_FACTORY_RESET, NULL, 0);
     if (rc < 0)
     {
         LOG_ERR("Failed to write perfom_factory_reset command (err %d).", rc);
         return rc;
     }
-    k_sleep(K_MSEC(SCD4X_FACTORY_RESET_WAIT_MS));
+    ((scd4x_data_t *)dev->data)->attr_shadow_valid = 0;
 
     rc = scd4x_setup_measurement(dev);
     if (rc < 0)
@@ -482,13 +707,12 @@ int scd4x_persist_settings(const struct device *dev)
         return rc;
     }
 
-    rc = scd4x_write_reg(dev, SCD4X_CMD_PERSIST_SETTINGS, NULL, 0);
+    rc = scd4x_send_cmd(dev, SCD4X_CMD_PERSIST_SETTINGS, NULL, 0);
     if (rc < 0)
     {
         LOG_ERR("Failed to write persist_settings command (err %d).", rc);
         return rc;
     }
-    k_sleep(K_MSEC(SCD4X_PERSIST_SETTINGS_WAIT_MS));
 
     rc = scd4x_setup_measurement(dev);
     if (rc < 0)
@@ -513,13 +737,12 @@ static int scd4x_selftest(const struct device *dev)
         return rc;
     }
 
-    rc = scd4x_write_reg(dev, SCD4X_CMD_PERFORM_SELF_TEST, NULL, 0);
+    rc = scd4x_send_cmd(dev, SCD4X_CMD_PERFORM_SELF_TEST, NULL, 0);
     if (rc < 0)
     {
         LOG_ERR("Failed to start selftest (err %d).", rc);
         return rc;
     }
-    k_sleep(K_MSEC(SCD4X_TEST_WAIT_MS));
 
     rc = scd4x_read_reg(dev, rx_buf, sizeof(rx_buf));
     if (rc < 0)
@@ -563,7 +786,10 @@ static int scd4x_pm_action(const struct device *dev,
         return -ENOTSUP;
     }
 
-    return scd4x_write_reg(dev, cmd, NULL, 0);
+    /* Volatile settings are lost while powered down */
+    ((scd4x_data_t *)dev->data)->attr_shadow_valid = 0;
+
+    return scd4x_send_cmd(dev, cmd, NULL, 0);
 }
 #endif /* CONFIG_PM_DEVICE */
 
@@ -579,29 +805,26 @@ static int scd4x_init(const struct device *dev)
     }
 
     // Wait for device wake up, and make sure it is woken up
-    rc = scd4x_write_reg(dev, SCD4X_CMD_WAKE_UP, NULL, 0);
+    rc = scd4x_send_cmd(dev, SCD4X_CMD_WAKE_UP, NULL, 0);
     if (rc < 0)
     {
         LOG_ERR("Failed to wake up the device (err %d).", rc);
         return rc;
     }
-    k_sleep(K_MSEC(SCD4X_WAKE_UP_WAIT_MS));
 
-    rc = scd4x_write_reg(dev, SCD4X_CMD_STOP_PERIODIC_MEASUREMENT, NULL, 0);
+    rc = scd4x_send_cmd(dev, SCD4X_CMD_STOP_PERIODIC_MEASUREMENT, NULL, 0);
     if (rc < 0)
     {
         LOG_ERR("Failed to put the device to idle mode (err %d).", rc);
         return rc;
     }
-    k_sleep(K_MSEC(SCD4X_STOP_PERIODIC_MEASUREMENT_WAIT_MS));
 
-    rc = scd4x_write_reg(dev, SCD4X_CMD_REINIT, NULL, 0);
+    rc = scd4x_send_cmd(dev, SCD4X_CMD_REINIT, NULL, 0);
     if (rc < 0)
     {
         LOG_ERR("Failed to reinitialize the device (err %d).", rc);
         return rc;
     }
-    k_sleep(K_MSEC(SCD4X_REINIT_WAIT_MS));
 
     if (cfg->selftest)
     {
@@ -639,6 +862,8 @@ static const struct sensor_driver_api scd4x_api = {
         .model = scd4x_model,                                            \
         .mode = DT_INST_ENUM_IDX_OR(inst, mode, SCD4X_MODE_NORMAL),      \
         .selftest = DT_INST_PROP(inst, enable_selftest),                 \
+        .ambient_pressure_tolerance =                                    \
+            DT_INST_PROP(inst, ambient_pressure_tolerance),              \
     };                                                                   \
                                                                          \
     PM_DEVICE_DT_INST_DEFINE(inst, scd4x_pm_action);                     \
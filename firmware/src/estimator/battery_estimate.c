@@ -0,0 +1,105 @@
+#include <estimator/battery_estimate.h>
+#include <components/state_manager.h>
+#include <components/e_paper_display.h>
+#include <drivers/recording_display.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/printk.h>
+
+#ifdef CONFIG_POWER_ESTIMATOR
+
+#define MS_PER_DAY (24LL * 3600 * 1000)
+
+// States charged with a current, the others are only timed
+static const state_t charged_states[] = {MEASURING, UPDATING, ADVERTISING, IDLE, SAMPLING};
+
+/**
+ * @brief Charge consumed per day in a state
+ *
+ * @param state State
+ * @param stats Statistics of the state
+ * @param uptime_ms Simulated time
+ * @return uint64_t, charge in microampere hours per day
+ */
+static uint64_t get_state_daily_charge(state_t state, const state_stats_t *stats, int64_t uptime_ms)
+{
+    uint64_t charge_uah = stats->charge_uah;
+
+#ifdef CONFIG_ENABLE_EPD
+    // The emulated display refreshes at once, add the time the panel takes for each update. The device idles
+    // meanwhile, that time is already charged as idle.
+    if (state == UPDATING)
+    {
+        charge_uah += (uint64_t)stats->entries * CONFIG_ESTIMATOR_EPD_REFRESH_MS *
+                      (CONFIG_STATE_CURRENT_UPDATING_UA - CONFIG_STATE_CURRENT_IDLE_UA) / (3600 * 1000);
+    }
+#endif
+    return charge_uah * MS_PER_DAY / uptime_ms;
+}
+
+/**
+ * @brief Print the traffic to the display recorded during the simulated days
+ *
+ */
+static void print_display_traffic(void)
+{
+#if defined(CONFIG_ENABLE_EPD) && defined(CONFIG_RECORDING_DISPLAY)
+    recording_display_stats_t display_stats;
+    recording_display_get_stats(DEVICE_DT_GET(DT_ALIAS(ssd1680)), &display_stats);
+    uint32_t refreshes = get_display_refreshes();
+
+    printk("\nDisplay %u refreshes (%u full, %u partial), %u writes, %llu bytes\n", refreshes,
+           display_stats.full_refreshes, display_stats.partial_refreshes, display_stats.writes,
+           (unsigned long long)display_stats.bytes);
+    if (refreshes > 0)
+    {
+        printk("Mean %llu bytes and %llu us rendering per refresh\n",
+               (unsigned long long)display_stats.bytes / refreshes,
+               (unsigned long long)get_display_render_time_us() / refreshes);
+    }
+    printk("%u refreshes deferred, %u skipped\n", get_deferred_refreshes(), get_skipped_refreshes());
+#endif
+}
+
+int print_battery_estimate(void)
+{
+    int64_t uptime_ms = k_uptime_get();
+    uint64_t daily_charge_uah[ARRAY_SIZE(charged_states)];
+    uint64_t total_uah = 0;
+    state_stats_t stats;
+
+    for (size_t i = 0; i < ARRAY_SIZE(charged_states); i++)
+    {
+        get_state_stats(charged_states[i], &stats);
+        daily_charge_uah[i] = get_state_daily_charge(charged_states[i], &stats, uptime_ms);
+        total_uah += daily_charge_uah[i];
+    }
+
+    printk("\nBattery life estimate after %d simulated days\n", CONFIG_ESTIMATOR_SIMULATED_DAYS);
+    printk("Advertisement interval %d ms, %d measurements per interval, EPD %s\n\n", CONFIG_ADVERTISEMENT_INTERVAL,
+           CONFIG_MEASUREMENTS_PER_INTERVAL, IS_ENABLED(CONFIG_ENABLE_EPD) ? "enabled" : "disabled");
+    printk("%-12s %8s %10s %10s %12s %6s\n", "State", "Entries", "Time (%)", "Mean (ms)", "uAh per day", "Share");
+    for (size_t i = 0; i < ARRAY_SIZE(charged_states); i++)
+    {
+        get_state_stats(charged_states[i], &stats);
+        printk("%-12s %8u %10lld %10lld %12llu %5llu%%\n", state_to_string(charged_states[i]), stats.entries,
+               (long long)(stats.total_ms * 100 / uptime_ms), (long long)stats.mean_ms,
+               (unsigned long long)daily_charge_uah[i],
+               (unsigned long long)(total_uah > 0 ? daily_charge_uah[i] * 100 / total_uah : 0));
+    }
+
+    printk("\nTotal %llu uAh per day, ", (unsigned long long)total_uah);
+    if (total_uah == 0)
+    {
+        printk("no charge accounted\n");
+        return -ENODATA;
+    }
+    printk("%llu days on a %d mAh battery\n",
+           (unsigned long long)CONFIG_ESTIMATOR_BATTERY_CAPACITY_MAH * 1000 / total_uah,
+           CONFIG_ESTIMATOR_BATTERY_CAPACITY_MAH);
+    print_display_traffic();
+    return 0;
+}
+
+#endif // CONFIG_POWER_ESTIMATOR
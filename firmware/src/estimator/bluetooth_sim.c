@@ -0,0 +1,146 @@
+#include <components/bluetooth_handler.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+
+#ifdef CONFIG_POWER_ESTIMATOR
+
+LOG_MODULE_REGISTER(bluetooth_sim);
+
+// Stand-in for bluetooth_handler.c on native_sim: a simulated central pairs during the pairing window, then
+// connects to each data advertisement, reads the values and disconnects after the configured delays
+
+static struct k_work_delayable pairing_work;
+static struct k_work_delayable connect_work;
+static struct k_work_delayable disconnect_work;
+
+static pairing_result_cb_t pairing_result_cb = NULL;
+static pairing_complete_cb_t pairing_complete_cb = NULL;
+static ble_exit_cb_t ble_exit_cb = NULL;
+static ble_connect_cb_t ble_connect_cb = NULL;
+
+static bool bonded = false;
+static bool ble_suspended = false;
+
+/**
+ * @brief Central paired and bonded
+ *
+ * @param work Work item
+ */
+static void central_paired(struct k_work *work)
+{
+    LOG_INF("Simulated central paired.");
+    bonded = true;
+    pairing_result_cb(true);
+    pairing_complete_cb(true);
+}
+
+/**
+ * @brief Central connected to the data advertisement, it reads the values before disconnecting
+ *
+ * @param work Work item
+ */
+static void central_connected(struct k_work *work)
+{
+    ble_connect_cb();
+    k_work_schedule(&disconnect_work, K_MSEC(CONFIG_ESTIMATOR_CENTRAL_READ_TIME));
+}
+
+/**
+ * @brief Central read the values and disconnected
+ *
+ * @param work Work item
+ */
+static void central_disconnected(struct k_work *work)
+{
+    ble_exit_cb(true);
+}
+
+int init_ble(void)
+{
+    int rc = 0;
+
+    // The settings are loaded with the bonds on the device, the gas index states are restored from them
+    rc = settings_subsys_init();
+    if (rc != 0)
+    {
+        LOG_ERR("Settings subsystem init failed (err %d).", rc);
+        return rc;
+    }
+    rc = settings_load();
+    if (rc != 0)
+    {
+        LOG_ERR("Loading settings failed (err %d).", rc);
+        return rc;
+    }
+
+    k_work_init_delayable(&pairing_work, central_paired);
+    k_work_init_delayable(&connect_work, central_connected);
+    k_work_init_delayable(&disconnect_work, central_disconnected);
+    return 0;
+}
+
+void register_pairing_result_cb(pairing_result_cb_t cb)
+{
+    pairing_result_cb = cb;
+}
+
+void register_pairing_complete_cb(pairing_complete_cb_t cb)
+{
+    pairing_complete_cb = cb;
+}
+
+void register_ble_task_cb(ble_exit_cb_t cb)
+{
+    ble_exit_cb = cb;
+}
+
+void register_ble_connect_cb(ble_connect_cb_t cb)
+{
+    ble_connect_cb = cb;
+}
+
+int start_pairing(void)
+{
+    k_work_schedule(&pairing_work, K_MSEC(CONFIG_ESTIMATOR_CENTRAL_CONNECT_DELAY));
+    return 0;
+}
+
+bool has_bonded_devices(void)
+{
+    return bonded;
+}
+
+int setup_data_advertisement(void)
+{
+    return 0;
+}
+
+void update_advertisement_data(void)
+{
+}
+
+int start_advertise(void)
+{
+    if (ble_suspended)
+    {
+        return -EAGAIN;
+    }
+    k_work_schedule(&connect_work, K_MSEC(CONFIG_ESTIMATOR_CENTRAL_CONNECT_DELAY));
+    return 0;
+}
+
+int suspend_ble(void)
+{
+    ble_suspended = true;
+    return 0;
+}
+
+int resume_ble(void)
+{
+    ble_suspended = false;
+    return 0;
+}
+
+#endif // CONFIG_POWER_ESTIMATOR
@@ -0,0 +1,28 @@
+#include <estimator/battery_estimate.h>
+
+#include <zephyr/kernel.h>
+
+#ifdef CONFIG_POWER_ESTIMATOR
+
+// Only available on native_sim
+#include <nsi_main.h>
+
+#define ESTIMATOR_THREAD_STACK_SIZE 1024
+#define ESTIMATOR_THREAD_PRIORITY K_PRIO_PREEMPT(1)
+
+/**
+ * @brief Let the application run for the simulated days, then print the per state breakdown and the battery life
+ *
+ */
+static void estimator_thread(void)
+{
+    k_sleep(K_HOURS(24 * CONFIG_ESTIMATOR_SIMULATED_DAYS));
+
+    print_battery_estimate();
+    nsi_exit(0);
+}
+
+K_THREAD_DEFINE(estimator_tid, ESTIMATOR_THREAD_STACK_SIZE, estimator_thread, NULL, NULL, NULL,
+                ESTIMATOR_THREAD_PRIORITY, 0, 0);
+
+#endif // CONFIG_POWER_ESTIMATOR
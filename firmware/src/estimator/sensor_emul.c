@@ -0,0 +1,241 @@
+#include <drivers/scd4x.h>
+#include <drivers/bmp390.h>
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/logging/log.h>
+
+#include <string.h>
+
+#ifdef CONFIG_POWER_ESTIMATOR
+
+LOG_MODULE_REGISTER(sensor_emul);
+
+// I2C emulators answering the sensor drivers on native_sim. The values are plausible constants with a small
+// wobble, the point is to run the real drivers with their real command sequences and execution times.
+
+#define SENSIRION_CRC_POLY 0x31
+#define SENSIRION_CRC_INIT 0xFF
+
+#define SGP40_CMD_SELF_TEST 0x280E
+#define SGP40_TEST_OK 0xD400
+
+// 22 degC and 45 %RH in the Sensirion tick formats
+#define TEMPERATURE_TICKS 25091
+#define SHT4X_HUMIDITY_TICKS 26738
+#define SCD4X_HUMIDITY_TICKS 29491
+#define VOC_RAW_TICKS 30000
+#define CO2_PPM 600
+
+// BMP390 raw temperature giving 25 degC with the calibration below
+#define BMP390_TEMPERATURE_RAW 8324841
+#define BMP390_PRESSURE_RAW 4194304
+
+typedef struct
+{
+    uint16_t cmd;   // Last command written
+    uint32_t count; // Samples read, for the wobble
+} sensirion_emul_data_t;
+
+typedef struct
+{
+    uint8_t regs[128];
+} bmp390_emul_data_t;
+
+static uint8_t sensirion_crc(uint16_t value)
+{
+    uint8_t crc = SENSIRION_CRC_INIT;
+    uint8_t bytes[2] = {value >> 8, value & 0xFF};
+    for (size_t i = 0; i < sizeof(bytes); i++)
+    {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x80) ? (crc << 1) ^ SENSIRION_CRC_POLY : crc << 1;
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief Fill a read buffer with words followed by their CRCs, the Sensirion read format
+ *
+ * @param buf Read buffer
+ * @param len Length of the buffer, multiple of 3
+ * @param words Words to return, repeated if the buffer is longer
+ * @param count Number of words
+ */
+static void sensirion_put_words(uint8_t *buf, uint32_t len, const uint16_t *words, size_t count)
+{
+    for (uint32_t i = 0; i + 3 <= len; i += 3)
+    {
+        uint16_t word = words[(i / 3) % count];
+        sys_put_be16(word, &buf[i]);
+        buf[i + 2] = sensirion_crc(word);
+    }
+}
+
+static uint16_t wobble(uint32_t count)
+{
+    return count % 7;
+}
+
+static int sht4x_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+    sensirion_emul_data_t *data = target->data;
+    for (int i = 0; i < num_msgs; i++)
+    {
+        if ((msgs[i].flags & I2C_MSG_RW_MASK) == I2C_MSG_WRITE)
+        {
+            data->cmd = msgs[i].buf[0];
+            continue;
+        }
+        uint16_t words[] = {TEMPERATURE_TICKS + wobble(data->count), SHT4X_HUMIDITY_TICKS - wobble(data->count)};
+        sensirion_put_words(msgs[i].buf, msgs[i].len, words, ARRAY_SIZE(words));
+        data->count++;
+    }
+    return 0;
+}
+
+static int sgp40_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+    sensirion_emul_data_t *data = target->data;
+    for (int i = 0; i < num_msgs; i++)
+    {
+        if ((msgs[i].flags & I2C_MSG_RW_MASK) == I2C_MSG_WRITE)
+        {
+            data->cmd = sys_get_be16(msgs[i].buf);
+            continue;
+        }
+        uint16_t word = data->cmd == SGP40_CMD_SELF_TEST ? SGP40_TEST_OK : VOC_RAW_TICKS + 10 * wobble(data->count++);
+        sensirion_put_words(msgs[i].buf, msgs[i].len, &word, 1);
+    }
+    return 0;
+}
+
+static int scd4x_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+    sensirion_emul_data_t *data = target->data;
+    for (int i = 0; i < num_msgs; i++)
+    {
+        if ((msgs[i].flags & I2C_MSG_RW_MASK) == I2C_MSG_WRITE)
+        {
+            data->cmd = sys_get_be16(msgs[i].buf);
+            continue;
+        }
+
+        uint16_t words[3] = {0};
+        switch (data->cmd)
+        {
+        case SCD4X_CMD_READ_MEASUREMENT:
+            words[0] = CO2_PPM + 5 * wobble(data->count);
+            words[1] = TEMPERATURE_TICKS;
+            words[2] = SCD4X_HUMIDITY_TICKS;
+            data->count++;
+            break;
+        case SCD4X_CMD_GET_DATA_READY_STATUS:
+            words[0] = 0x8006;
+            break;
+        case SCD4X_CMD_PERFORM_FORCED_RECALIBRATION:
+            words[0] = 0x8000;
+            break;
+        default:
+            // SCD4X_TEST_OK for the self test, zeros for the getters
+            break;
+        }
+        sensirion_put_words(msgs[i].buf, msgs[i].len, words, ARRAY_SIZE(words));
+    }
+    return 0;
+}
+
+static int bmp390_emul_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs, int addr)
+{
+    bmp390_emul_data_t *data = target->data;
+    uint8_t reg = 0;
+    for (int i = 0; i < num_msgs; i++)
+    {
+        if ((msgs[i].flags & I2C_MSG_RW_MASK) == I2C_MSG_WRITE)
+        {
+            // Register address followed by the values to write, the address auto-increments
+            reg = msgs[i].buf[0];
+            for (uint32_t j = 1; j < msgs[i].len && reg < sizeof(data->regs); j++)
+            {
+                data->regs[reg++] = msgs[i].buf[j];
+            }
+            // A forced conversion completes at once and returns to sleep, the driver sleeps for its duration
+            if ((data->regs[BMP390_REG_PWR_CTRL] & BMP390_PWR_CTRL_MODE_MASK) == BMP390_PWR_CTRL_MODE_FORCED)
+            {
+                data->regs[BMP390_REG_PWR_CTRL] &= ~BMP390_PWR_CTRL_MODE_MASK;
+            }
+            continue;
+        }
+        for (uint32_t j = 0; j < msgs[i].len; j++)
+        {
+            msgs[i].buf[j] = reg + j < sizeof(data->regs) ? data->regs[reg + j] : 0;
+        }
+    }
+    return 0;
+}
+
+static int sensirion_emul_init(const struct emul *target, const struct device *parent)
+{
+    memset(target->data, 0, sizeof(sensirion_emul_data_t));
+    return 0;
+}
+
+static int bmp390_emul_init(const struct emul *target, const struct device *parent)
+{
+    bmp390_emul_data_t *data = target->data;
+    memset(data->regs, 0, sizeof(data->regs));
+    data->regs[BMP390_REG_CHIPID] = BMP390_CHIP_ID;
+    data->regs[BMP390_REG_STATUS] = BMP390_STATUS_CMD_RDY | BMP390_STATUS_DRDY_PRESS | BMP390_STATUS_DRDY_TEMP;
+    sys_put_le24(BMP390_PRESSURE_RAW, &data->regs[BMP390_REG_DATA0]);
+    sys_put_le24(BMP390_TEMPERATURE_RAW, &data->regs[BMP390_REG_DATA3]);
+
+    // Calibration giving 25 degC and a constant 101328 Pa: only t1, t2, p1 (offset by 16384) and p5 are set
+    bmp390_cal_data_t cal = {0};
+    cal.t1 = sys_cpu_to_le16(27000);
+    cal.t2 = sys_cpu_to_le16(19000);
+    cal.p1 = sys_cpu_to_le16(16384);
+    cal.p5 = sys_cpu_to_le16(12666);
+    memcpy(&data->regs[BMP390_REG_CALIB0], &cal, sizeof(cal));
+    return 0;
+}
+
+static const struct i2c_emul_api sht4x_emul_api = {.transfer = sht4x_emul_transfer};
+static const struct i2c_emul_api sgp40_emul_api = {.transfer = sgp40_emul_transfer};
+static const struct i2c_emul_api scd4x_emul_api = {.transfer = scd4x_emul_transfer};
+static const struct i2c_emul_api bmp390_emul_api = {.transfer = bmp390_emul_transfer};
+
+#define SENSIRION_EMUL(inst, api)                                  \
+    static sensirion_emul_data_t sensirion_emul_data_##api##inst; \
+    EMUL_DT_INST_DEFINE(inst, sensirion_emul_init, &sensirion_emul_data_##api##inst, NULL, &api, NULL);
+
+#define SHT4X_EMUL(inst) SENSIRION_EMUL(inst, sht4x_emul_api)
+#define SGP40_EMUL(inst) SENSIRION_EMUL(inst, sgp40_emul_api)
+#define SCD4X_EMUL(inst) SENSIRION_EMUL(inst, scd4x_emul_api)
+
+#define BMP390_EMUL(inst)                                  \
+    static bmp390_emul_data_t bmp390_emul_data_##inst;     \
+    EMUL_DT_INST_DEFINE(inst, bmp390_emul_init, &bmp390_emul_data_##inst, NULL, &bmp390_emul_api, NULL);
+
+#define DT_DRV_COMPAT sensirion_sht4x
+DT_INST_FOREACH_STATUS_OKAY(SHT4X_EMUL)
+#undef DT_DRV_COMPAT
+
+#define DT_DRV_COMPAT sensirion_sgp40
+DT_INST_FOREACH_STATUS_OKAY(SGP40_EMUL)
+#undef DT_DRV_COMPAT
+
+#define DT_DRV_COMPAT sensirion_scd41
+DT_INST_FOREACH_STATUS_OKAY(SCD4X_EMUL)
+#undef DT_DRV_COMPAT
+
+#define DT_DRV_COMPAT bosch_bmp390
+DT_INST_FOREACH_STATUS_OKAY(BMP390_EMUL)
+#undef DT_DRV_COMPAT
+
+#endif // CONFIG_POWER_ESTIMATOR
@@ -0,0 +1,119 @@
+#include <utils/bitmap_font.h>
+
+#include <zephyr/sys/util.h>
+
+#include <stddef.h>
+#include <string.h>
+
+const bitmap_glyph_t *bitmap_font_find_glyph(const bitmap_font_t *font, uint8_t code)
+{
+    // Glyphs are sorted by code
+    int low = 0;
+    int high = font->glyph_count - 1;
+    while (low <= high)
+    {
+        int mid = (low + high) / 2;
+        if (font->glyphs[mid].code == code)
+        {
+            return &font->glyphs[mid];
+        }
+        if (font->glyphs[mid].code < code)
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid - 1;
+        }
+    }
+    return NULL;
+}
+
+int bitmap_font_text_width(const bitmap_font_t *font, const char *text)
+{
+    int width = 0;
+    for (const char *c = text; *c != '\0'; c++)
+    {
+        const bitmap_glyph_t *glyph = bitmap_font_find_glyph(font, (uint8_t)*c);
+        if (glyph != NULL)
+        {
+            width += glyph->adv_w;
+        }
+    }
+    return width;
+}
+
+void bitmap_glyph_reader_init(bitmap_glyph_reader_t *reader, const bitmap_font_t *font, const bitmap_glyph_t *glyph)
+{
+    reader->font = font;
+    reader->glyph = glyph;
+    reader->position = (uint32_t)glyph->bitmap_index * (font->compressed ? 2 : 8);
+    reader->run = 0;
+    reader->color = true; // The first run is zeros
+    memset(reader->row, 0, sizeof(reader->row));
+}
+
+static uint8_t read_nibble(bitmap_glyph_reader_t *reader)
+{
+    uint8_t byte = reader->font->bitmap[reader->position / 2];
+    uint8_t nibble = reader->position % 2 == 0 ? byte >> 4 : byte & 0x0F;
+    reader->position++;
+    return nibble;
+}
+
+/**
+ * @brief Decode the next row of a compressed glyph, the decoded bits are XORed onto the previous row
+ *
+ * @param reader Reader
+ */
+static void read_compressed_row(bitmap_glyph_reader_t *reader)
+{
+    int col = 0;
+    while (col < reader->glyph->box_w)
+    {
+        if (reader->run == 0)
+        {
+            // Next run, the length continues while the nibbles are 15
+            uint8_t nibble;
+            do
+            {
+                nibble = read_nibble(reader);
+                reader->run += nibble;
+            } while (nibble == 15);
+            reader->color = !reader->color;
+            continue;
+        }
+
+        int count = MIN(reader->run, reader->glyph->box_w - col);
+        if (reader->color)
+        {
+            // Ones flip the pixels of the previous row
+            for (int bit = col; bit < col + count; bit++)
+            {
+                reader->row[bit / 8] ^= 0x80 >> (bit % 8);
+            }
+        }
+        col += count;
+        reader->run -= count;
+    }
+}
+
+const uint8_t *bitmap_glyph_read_row(bitmap_glyph_reader_t *reader)
+{
+    if (reader->font->compressed)
+    {
+        read_compressed_row(reader);
+        return reader->row;
+    }
+
+    // Uncompressed rows are not byte aligned, copy the bits of the row
+    memset(reader->row, 0, sizeof(reader->row));
+    for (int col = 0; col < reader->glyph->box_w; col++, reader->position++)
+    {
+        if ((reader->font->bitmap[reader->position / 8] >> (7 - reader->position % 8)) & 1)
+        {
+            reader->row[col / 8] |= 0x80 >> (col % 8);
+        }
+    }
+    return reader->row;
+}
@@ -0,0 +1,46 @@
+#include <utils/decimal_format.h>
+
+#include <stdbool.h>
+
+size_t format_decimal(char *buf, size_t size, int32_t value, uint8_t decimals, const char *suffix)
+{
+    if (size == 0)
+    {
+        return 0;
+    }
+
+    // Digits are collected from the last one, in unsigned arithmetic so INT32_MIN does not overflow
+    char digits[12];
+    size_t count = 0;
+    bool negative = value < 0;
+    uint32_t magnitude = negative ? 0u - (uint32_t)value : (uint32_t)value;
+    do
+    {
+        digits[count++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while ((magnitude > 0 || count <= decimals) && count < sizeof(digits));
+
+    size_t length = 0;
+    if (negative && length < size - 1)
+    {
+        buf[length++] = '-';
+    }
+    while (count > 0 && length < size - 1)
+    {
+        if (count == decimals)
+        {
+            buf[length++] = '.';
+            if (length == size - 1)
+            {
+                break;
+            }
+        }
+        buf[length++] = digits[--count];
+    }
+    while (*suffix != '\0' && length < size - 1)
+    {
+        buf[length++] = *suffix++;
+    }
+    buf[length] = '\0';
+    return length;
+}
@@ -0,0 +1,408 @@
+#include <utils/gas_index_fixed.h>
+
+#include <zephyr/sys/util.h>
+
+#ifdef CONFIG_GAS_INDEX_FIXED_POINT
+
+#define F16(x) ((fix16_t)(((x) >= 0) ? ((x) * 65536.0 + 0.5) : ((x) * 65536.0 - 0.5)))
+#define F30(x) ((fix30_t)(((x) >= 0) ? ((x) * 1073741824.0 + 0.5) : ((x) * 1073741824.0 - 0.5)))
+#define F16_ONE F16(1)
+#define F30_ONE F30(1)
+
+// Algorithm constants, see sensirion_gas_index_algorithm.h
+#define INITIAL_BLACKOUT F16(45)
+#define INDEX_GAIN 230
+#define SRAW_STD_INITIAL F16(50)
+#define SRAW_STD_BONUS F16(220)
+#define TAU_MEAN_S (12 * 3600)
+#define TAU_VARIANCE_S (12 * 3600)
+#define TAU_INITIAL_MEAN_S 20
+#define TAU_INITIAL_VARIANCE_S 2500
+#define INIT_DURATION_MEAN F16(3600 * 0.75)
+#define INIT_TRANSITION_MEAN F30(0.01)
+#define INIT_DURATION_VARIANCE F16(3600 * 1.45)
+#define INIT_TRANSITION_VARIANCE F30(0.01)
+#define GATING_THRESHOLD F16(340)
+#define GATING_THRESHOLD_INITIAL F16(510)
+#define GATING_THRESHOLD_TRANSITION F30(0.09)
+// Gating time is accumulated in seconds, a minute step of 1/60 is not exact in fixed-point
+#define GATING_MAX_DURATION_S F16(3 * 3600)
+#define GATING_MAX_RATIO F30(0.3)
+#define SIGMOID_L 500
+#define SIGMOID_K F30(-0.0065)
+#define SIGMOID_X0 F16(213)
+#define LP_TAU_FAST_S 20
+#define LP_TAU_SLOW_S 500
+#define LP_TAU_FAST F16(LP_TAU_FAST_S)
+#define LP_TAU_SLOW F16(LP_TAU_SLOW_S)
+#define LP_ALPHA F30(-0.2)
+#define SRAW_MINIMUM 20000
+#define PERSISTENCE_UPTIME_GAMMA F16(3 * 3600)
+#define UPTIME_MAX F16(32767)
+// The mox model output saturates the index sigmoid long before this, keeps the sigmoid input in range
+#define MOX_LIMIT F16(16384)
+
+// exp(x) rounds to zero in Q2.30 below ln(0.5 / 2^30)
+#define EXP_INPUT_MIN F16(-21.5)
+#define LOG2_E F30(1.4426950408889634)
+#define LN_2 F30(0.6931471805599453)
+
+// 1 / n! for n = 0..7
+static const fix30_t exp_coefficients[] = {
+    1073741824, 1073741824, 536870912, 178956971, 44739243, 8947849, 1491308, 213044,
+};
+
+// Initial estimate 48/17 - 32/17 * d of the reciprocal of d in [0.5, 1), error below 1/17
+#define RECIPROCAL_C1 3031741621u
+#define RECIPROCAL_C2 2021161080u
+#define RECIPROCAL_ITERATIONS 3
+
+/**
+ * @brief Product of a value and a Q2.30 fraction, rounded to nearest in the format of the value
+ */
+static int32_t mul30(int32_t value, fix30_t fraction)
+{
+    return (int32_t)(((int64_t)value * fraction + (1 << 29)) >> 30);
+}
+
+/**
+ * @brief Product of an unsigned 64-bit value below 2^63 and a Q2.30 fraction of at most one, rounded to nearest
+ */
+static uint64_t mul30_u64(uint64_t value, fix30_t fraction)
+{
+    uint64_t high = (value >> 32) * (uint32_t)fraction;
+    uint64_t low = (value & UINT32_MAX) * (uint32_t)fraction;
+    return (high << 2) + ((low + (1 << 29)) >> 30);
+}
+
+/**
+ * @brief Quotient of two positive values in the same format, rounded to nearest with the given fractional bits.
+ * Newton-Raphson iterations on the reciprocal of the divisor, so no 64-bit division runs on cores without a divider.
+ *
+ * @param num Dividend
+ * @param den Divisor
+ * @param frac_bits Fractional bits of the quotient, at most 30
+ * @return uint32_t, quotient, saturated
+ */
+static uint32_t fix_div(uint32_t num, uint32_t den, int frac_bits)
+{
+    if (den == 0)
+    {
+        return UINT32_MAX;
+    }
+    // Divisor normalized to [0.5, 1) in Q0.32, its reciprocal x in Q2.30
+    int shift = __builtin_clz(den);
+    uint32_t d = den << shift;
+    uint32_t x = RECIPROCAL_C1 - (uint32_t)(((uint64_t)RECIPROCAL_C2 * d) >> 32);
+    for (int i = 0; i < RECIPROCAL_ITERATIONS; i++)
+    {
+        // x += x * (1 - d * x), the error is squared on each iteration
+        int64_t error = F30_ONE - (int64_t)(((uint64_t)d * x) >> 32);
+        x += (int32_t)(((int64_t)x * error) >> 30);
+    }
+
+    // num / den = num * x * 2^shift / 2^62
+    int quotient_shift = 62 - shift - frac_bits;
+    uint64_t quotient = (uint64_t)num * x;
+    quotient = quotient_shift > 0 ? (quotient + ((uint64_t)1 << (quotient_shift - 1))) >> quotient_shift
+                                   : quotient << -quotient_shift;
+    return quotient > UINT32_MAX ? UINT32_MAX : (uint32_t)quotient;
+}
+
+/**
+ * @brief Square root of a Q32.32 value, rounded to nearest Q16.16
+ */
+static fix16_t fix16_sqrt64(uint64_t radicand)
+{
+    uint64_t result = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > radicand)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (radicand >= result + bit)
+        {
+            radicand -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    if (radicand > result)
+    {
+        result++;
+    }
+    return result > INT32_MAX ? INT32_MAX : (fix16_t)result;
+}
+
+/**
+ * @brief exp(x) for x <= 0
+ *
+ * @param x Exponent in Q16.16
+ * @return fix30_t, exp(x) in Q2.30
+ */
+static fix30_t fix30_exp_neg(fix16_t x)
+{
+    if (x <= EXP_INPUT_MIN)
+    {
+        return 0;
+    }
+    // exp(x) = 2^k * exp(r) with x * log2(e) = k + f, k the nearest integer and r = f * ln(2), |r| <= ln(2) / 2
+    int64_t y = ((int64_t)x * LOG2_E + (1 << 15)) >> 16;
+    int32_t k = (int32_t)((y + (1 << 29)) >> 30);
+    fix30_t r = mul30((fix30_t)(y - ((int64_t)k << 30)), LN_2);
+
+    // Taylor series up to r^7 in Horner form, error below 1e-8
+    fix30_t e = exp_coefficients[ARRAY_SIZE(exp_coefficients) - 1];
+    for (int i = ARRAY_SIZE(exp_coefficients) - 2; i >= 0; i--)
+    {
+        e = exp_coefficients[i] + mul30(e, r);
+    }
+    // k <= 0 as x <= 0
+    return k == 0 ? e : (e + (1 << (-k - 1))) >> -k;
+}
+
+/**
+ * @brief Logistic function 1 / (1 + exp(k * (sample - x0)))
+ *
+ * @param sample Input in Q16.16
+ * @param x0 Midpoint in Q16.16
+ * @param k Slope in Q2.30
+ * @return fix30_t, output in Q2.30
+ */
+static fix30_t sigmoid(fix16_t sample, fix16_t x0, fix30_t k)
+{
+    int64_t x = ((int64_t)k * ((int64_t)sample - x0) + (1 << 29)) >> 30;
+    x = CLAMP(x, -INT32_MAX, INT32_MAX);
+    if (x >= 0)
+    {
+        // exp(-x) / (1 + exp(-x)), keeps the exponential within Q2.30
+        fix30_t e = fix30_exp_neg((fix16_t)-x);
+        return (fix30_t)fix_div(e, F30_ONE + (uint32_t)e, 30);
+    }
+    fix30_t e = fix30_exp_neg((fix16_t)x);
+    return (fix30_t)fix_div(F30_ONE, F30_ONE + (uint32_t)e, 30);
+}
+
+static void mox_model_set_parameters(gas_index_fixed_params_t *params)
+{
+    params->mox_sraw_mean = params->mve_mean + params->mve_sraw_offset;
+    params->mox_scale = (fix30_t)fix_div(INDEX_GAIN * F16_ONE, params->mve_std + SRAW_STD_BONUS, 30);
+}
+
+static fix16_t mox_model_process(const gas_index_fixed_params_t *params, fix16_t sraw)
+{
+    int64_t mox = -((((int64_t)sraw - params->mox_sraw_mean) * params->mox_scale + (1 << 29)) >> 30);
+    return (fix16_t)CLAMP(mox, -MOX_LIMIT, MOX_LIMIT);
+}
+
+/**
+ * @brief Map the mox model output to the index, with the default offset of 100 the sigmoid shift is zero
+ */
+static fix16_t sigmoid_scaled_process(fix16_t sample)
+{
+    fix30_t s = sigmoid(sample, SIGMOID_X0, SIGMOID_K);
+    return (fix16_t)(((int64_t)s * SIGMOID_L + (1 << 13)) >> 14);
+}
+
+static fix16_t adaptive_lowpass_process(gas_index_fixed_params_t *params, fix16_t sample)
+{
+    if (!params->lp_initialized)
+    {
+        params->lp_x1 = sample;
+        params->lp_x2 = sample;
+        params->lp_x3 = sample;
+        params->lp_initialized = true;
+    }
+    // (1 - a) * x + a * sample
+    params->lp_x1 += mul30(sample - params->lp_x1, params->lp_a1);
+    params->lp_x2 += mul30(sample - params->lp_x2, params->lp_a2);
+
+    fix16_t abs_delta = params->lp_x1 - params->lp_x2;
+    if (abs_delta < 0)
+    {
+        abs_delta = -abs_delta;
+    }
+    fix30_t f1 = fix30_exp_neg(mul30(abs_delta, LP_ALPHA));
+    fix16_t tau_a = mul30(LP_TAU_SLOW - LP_TAU_FAST, f1) + LP_TAU_FAST;
+    fix30_t a3 = (fix30_t)fix_div(params->sampling_interval, params->sampling_interval + tau_a, 30);
+    params->lp_x3 += mul30(sample - params->lp_x3, a3);
+    return params->lp_x3;
+}
+
+static void mean_variance_estimator_calculate_gamma(gas_index_fixed_params_t *params)
+{
+    fix16_t uptime_limit = UPTIME_MAX - params->sampling_interval;
+    if (params->mve_uptime_gamma < uptime_limit)
+    {
+        params->mve_uptime_gamma += params->sampling_interval;
+    }
+    if (params->mve_uptime_gating < uptime_limit)
+    {
+        params->mve_uptime_gating += params->sampling_interval;
+    }
+
+    fix30_t sigmoid_gamma_mean = sigmoid(params->mve_uptime_gamma, INIT_DURATION_MEAN, INIT_TRANSITION_MEAN);
+    fix30_t gamma_mean = params->mve_gamma_mean_base +
+                         mul30(params->mve_gamma_initial_mean - params->mve_gamma_mean_base, sigmoid_gamma_mean);
+    fix16_t gating_threshold = GATING_THRESHOLD +
+                               mul30(GATING_THRESHOLD_INITIAL - GATING_THRESHOLD,
+                                     sigmoid(params->mve_uptime_gating, INIT_DURATION_MEAN, INIT_TRANSITION_MEAN));
+    fix30_t sigmoid_gating_mean = sigmoid(params->gas_index, gating_threshold, GATING_THRESHOLD_TRANSITION);
+    params->mve_gamma_mean = mul30(gamma_mean, sigmoid_gating_mean);
+
+    fix30_t sigmoid_gamma_variance =
+        sigmoid(params->mve_uptime_gamma, INIT_DURATION_VARIANCE, INIT_TRANSITION_VARIANCE);
+    fix30_t gamma_variance = params->mve_gamma_variance_base +
+                             mul30(params->mve_gamma_initial_variance - params->mve_gamma_variance_base,
+                                   sigmoid_gamma_variance - sigmoid_gamma_mean);
+    gating_threshold = GATING_THRESHOLD +
+                       mul30(GATING_THRESHOLD_INITIAL - GATING_THRESHOLD,
+                             sigmoid(params->mve_uptime_gating, INIT_DURATION_VARIANCE, INIT_TRANSITION_VARIANCE));
+    fix30_t sigmoid_gating_variance = sigmoid(params->gas_index, gating_threshold, GATING_THRESHOLD_TRANSITION);
+    params->mve_gamma_variance = mul30(gamma_variance, sigmoid_gating_variance);
+
+    // Interval times (1 - sigmoid) * (1 + ratio) - ratio, from Q2.30 times whole seconds to Q16.16
+    fix30_t gating_rate = mul30(F30_ONE - sigmoid_gating_mean, F30_ONE + GATING_MAX_RATIO) - GATING_MAX_RATIO;
+    params->mve_gating_duration_s +=
+        (fix16_t)(((int64_t)gating_rate * params->sampling_interval_s + (1 << 13)) >> 14);
+    if (params->mve_gating_duration_s < 0)
+    {
+        params->mve_gating_duration_s = 0;
+    }
+    if (params->mve_gating_duration_s > GATING_MAX_DURATION_S)
+    {
+        params->mve_uptime_gating = 0;
+    }
+}
+
+static void mean_variance_estimator_process(gas_index_fixed_params_t *params, fix16_t sraw)
+{
+    if (!params->mve_initialized)
+    {
+        params->mve_initialized = true;
+        params->mve_sraw_offset = sraw;
+        params->mve_mean = 0;
+        return;
+    }
+
+    if (params->mve_mean >= F16(100) || params->mve_mean <= F16(-100))
+    {
+        params->mve_sraw_offset += params->mve_mean;
+        params->mve_mean = 0;
+    }
+    sraw -= params->mve_sraw_offset;
+    mean_variance_estimator_calculate_gamma(params);
+
+    // The float version scales by the gamma scaling and an additional scaling to keep Q16.16 in range, both cancel
+    // out: std^2 = (1 - gamma_variance) * (std^2 + gamma_variance * delta^2) with the squares in Q32.32
+    int64_t delta = (int64_t)sraw - params->mve_mean;
+    uint64_t delta_sq = (uint64_t)(delta * delta);
+    uint64_t variance = (uint64_t)params->mve_std * (uint64_t)params->mve_std;
+    variance = mul30_u64(variance + mul30_u64(delta_sq, params->mve_gamma_variance),
+                         F30_ONE - params->mve_gamma_variance);
+    params->mve_std = fix16_sqrt64(variance);
+    params->mve_mean += (fix16_t)((delta * params->mve_gamma_mean + (1 << 29)) >> 30);
+}
+
+void gas_index_fixed_init(gas_index_fixed_params_t *params, int32_t sampling_interval_s)
+{
+    *params = (gas_index_fixed_params_t){0};
+    params->sampling_interval_s = sampling_interval_s;
+    params->sampling_interval = sampling_interval_s * F16_ONE;
+
+    // Rates interval / (tau + interval), from whole seconds
+    int32_t interval = sampling_interval_s;
+    params->mve_std = SRAW_STD_INITIAL;
+    params->mve_gamma_mean_base = (fix30_t)fix_div(interval, TAU_MEAN_S + interval, 30);
+    params->mve_gamma_variance_base = (fix30_t)fix_div(interval, TAU_VARIANCE_S + interval, 30);
+    params->mve_gamma_initial_mean = (fix30_t)fix_div(interval, TAU_INITIAL_MEAN_S + interval, 30);
+    params->mve_gamma_initial_variance = (fix30_t)fix_div(interval, TAU_INITIAL_VARIANCE_S + interval, 30);
+
+    params->lp_a1 = (fix30_t)fix_div(interval, LP_TAU_FAST_S + interval, 30);
+    params->lp_a2 = (fix30_t)fix_div(interval, LP_TAU_SLOW_S + interval, 30);
+
+    mox_model_set_parameters(params);
+}
+
+/**
+ * @brief Process one sample after the initial blackout
+ */
+static inline void process_sample(gas_index_fixed_params_t *params, int32_t sraw)
+{
+    if (sraw > 0 && sraw < 65000)
+    {
+        sraw = CLAMP(sraw, SRAW_MINIMUM + 1, SRAW_MINIMUM + 32767);
+        params->sraw = (sraw - SRAW_MINIMUM) * F16_ONE;
+    }
+    params->gas_index = sigmoid_scaled_process(mox_model_process(params, params->sraw));
+    params->gas_index = adaptive_lowpass_process(params, params->gas_index);
+    if (params->gas_index < F16(0.5))
+    {
+        params->gas_index = F16(0.5);
+    }
+    if (params->sraw > 0)
+    {
+        mean_variance_estimator_process(params, params->sraw);
+        mox_model_set_parameters(params);
+    }
+}
+
+void gas_index_fixed_process(gas_index_fixed_params_t *params, int32_t sraw, int32_t *gas_index)
+{
+    if (params->uptime <= INITIAL_BLACKOUT)
+    {
+        params->uptime += params->sampling_interval;
+    }
+    else
+    {
+        process_sample(params, sraw);
+    }
+    *gas_index = (params->gas_index + F16(0.5)) >> 16;
+}
+
+void gas_index_fixed_process_batch(gas_index_fixed_params_t *params, const int32_t *sraw, int32_t *gas_index,
+                                   size_t count)
+{
+    // Work on a local copy, it cannot alias the arrays so the compiler keeps the hot states in registers
+    gas_index_fixed_params_t state = *params;
+    size_t i = 0;
+
+    // Samples during the initial blackout only advance the uptime
+    for (; i < count && state.uptime <= INITIAL_BLACKOUT; i++)
+    {
+        state.uptime += state.sampling_interval;
+        gas_index[i] = (state.gas_index + F16(0.5)) >> 16;
+    }
+    for (; i < count; i++)
+    {
+        process_sample(&state, sraw[i]);
+        gas_index[i] = (state.gas_index + F16(0.5)) >> 16;
+    }
+
+    *params = state;
+}
+
+void gas_index_fixed_get_states(const gas_index_fixed_params_t *params, float *state0, float *state1)
+{
+    *state0 = (float)(params->mve_mean + params->mve_sraw_offset) / 65536.0f;
+    *state1 = (float)params->mve_std / 65536.0f;
+}
+
+void gas_index_fixed_set_states(gas_index_fixed_params_t *params, float state0, float state1)
+{
+    params->mve_mean = (fix16_t)(state0 * 65536.0f);
+    params->mve_sraw_offset = 0;
+    params->mve_std = (fix16_t)(state1 * 65536.0f);
+    params->mve_uptime_gamma = PERSISTENCE_UPTIME_GAMMA;
+    params->mve_initialized = true;
+    mox_model_set_parameters(params);
+    params->sraw = params->mve_mean;
+}
+
+#endif // CONFIG_GAS_INDEX_FIXED_POINT
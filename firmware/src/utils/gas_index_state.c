@@ -0,0 +1,169 @@
+#include <utils/gas_index_state.h>
+#include <utils/retained_state.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/drivers/hwinfo.h>
+
+#include <errno.h>
+#include <string.h>
+
+#ifdef CONFIG_GAS_INDEX_PERSIST_STATE
+
+LOG_MODULE_REGISTER(gas_index_state);
+
+#define GAS_INDEX_STATE_KEY "gas_index/voc"
+#define GAS_INDEX_STATE_VERSION 1
+
+// The algorithm states are only valid after 3 hours of continuous operation
+#define GAS_INDEX_MIN_LEARNING_TIME_S (3 * 60 * 60)
+
+typedef struct
+{
+    uint8_t version;
+    float state0;
+    float state1;
+    uint32_t learning_time_s; // Time the algorithm has been learning
+} gas_index_checkpoint_t;
+
+static gas_index_checkpoint_t loaded_checkpoint;
+static bool checkpoint_loaded;
+
+static uint32_t learning_time_s;
+static uint32_t last_checkpoint_s;
+
+static int gas_index_settings_set(const char *name, size_t len, settings_read_cb read_cb, void *cb_arg)
+{
+    if (strcmp(name, "voc") != 0)
+    {
+        return -ENOENT;
+    }
+    if (len != sizeof(loaded_checkpoint))
+    {
+        return -EINVAL;
+    }
+
+    int rc = read_cb(cb_arg, &loaded_checkpoint, sizeof(loaded_checkpoint));
+    if (rc < 0)
+    {
+        return rc;
+    }
+    checkpoint_loaded = true;
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(gas_index, "gas_index", NULL, gas_index_settings_set, NULL, NULL);
+
+/**
+ * @brief Check whether the interruption since the checkpoint is short enough for the states to be used.
+ * There is no real time clock, so the reset cause is used: the device kept power over a soft reset,
+ * watchdog or firmware update, while a power-on reset (e.g. a battery swap) has an unknown duration.
+ *
+ * @return true if the checkpoint can be restored, false otherwise
+ */
+static bool interruption_was_short(void)
+{
+    uint32_t cause = 0;
+    int rc = hwinfo_get_reset_cause(&cause);
+    if (rc != 0)
+    {
+        LOG_WRN("Failed to get reset cause (err %d).", rc);
+        return false;
+    }
+    hwinfo_clear_reset_cause();
+
+    if (cause == 0 || (cause & (RESET_POR | RESET_BROWNOUT | RESET_LOW_POWER_WAKE)))
+    {
+        return IS_ENABLED(CONFIG_GAS_INDEX_RESTORE_AFTER_POWER_LOSS);
+    }
+    return true;
+}
+
+int restore_gas_index_state(float *state0, float *state1)
+{
+#ifdef CONFIG_RETAINED_STATE
+    // The RAM copy stayed powered over the reset and is newer than the last checkpoint
+    retained_state_t *retained = get_retained_state();
+    if (retained_state_is_warm() && retained->gas_index_learning_time_s >= GAS_INDEX_MIN_LEARNING_TIME_S)
+    {
+        *state0 = retained->gas_index_state0;
+        *state1 = retained->gas_index_state1;
+        learning_time_s = retained->gas_index_learning_time_s;
+        last_checkpoint_s = learning_time_s;
+        LOG_INF("Gas index states restored from retained RAM after %u s of learning.", learning_time_s);
+        return 0;
+    }
+#endif
+
+    if (!checkpoint_loaded)
+    {
+        LOG_INF("No gas index checkpoint stored.");
+        return -ENOENT;
+    }
+    if (loaded_checkpoint.version != GAS_INDEX_STATE_VERSION ||
+        loaded_checkpoint.learning_time_s < GAS_INDEX_MIN_LEARNING_TIME_S)
+    {
+        LOG_INF("Gas index checkpoint not usable, learning from scratch.");
+        return -EINVAL;
+    }
+    if (!interruption_was_short())
+    {
+        LOG_INF("Gas index checkpoint too old, learning from scratch.");
+        return -ESTALE;
+    }
+
+    *state0 = loaded_checkpoint.state0;
+    *state1 = loaded_checkpoint.state1;
+    learning_time_s = loaded_checkpoint.learning_time_s;
+    last_checkpoint_s = learning_time_s;
+    LOG_INF("Gas index states restored after %u s of learning.", learning_time_s);
+    return 0;
+}
+
+int save_gas_index_state(float state0, float state1)
+{
+    if (learning_time_s < GAS_INDEX_MIN_LEARNING_TIME_S)
+    {
+        // States are not meaningful yet, keep the previous checkpoint
+        return 0;
+    }
+
+    gas_index_checkpoint_t checkpoint = {
+        .version = GAS_INDEX_STATE_VERSION,
+        .state0 = state0,
+        .state1 = state1,
+        .learning_time_s = learning_time_s,
+    };
+
+    int rc = settings_save_one(GAS_INDEX_STATE_KEY, &checkpoint, sizeof(checkpoint));
+    if (rc != 0)
+    {
+        LOG_ERR("Failed to save gas index states (err %d).", rc);
+        return rc;
+    }
+    last_checkpoint_s = learning_time_s;
+    LOG_DBG("Gas index states saved.");
+    return 0;
+}
+
+int update_gas_index_state(uint32_t sampling_interval_s, float state0, float state1)
+{
+    learning_time_s += sampling_interval_s;
+
+#ifdef CONFIG_RETAINED_STATE
+    retained_state_t *retained = lock_retained_state();
+    retained->gas_index_state0 = state0;
+    retained->gas_index_state1 = state1;
+    retained->gas_index_learning_time_s = learning_time_s;
+    unlock_retained_state();
+#endif
+
+    if (learning_time_s - last_checkpoint_s < CONFIG_GAS_INDEX_CHECKPOINT_INTERVAL_S)
+    {
+        return 0;
+    }
+    return save_gas_index_state(state0, state1);
+}
+
+#endif // CONFIG_GAS_INDEX_PERSIST_STATE
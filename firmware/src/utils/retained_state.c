@@ -0,0 +1,110 @@
+#include <utils/retained_state.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/crc.h>
+
+#include <stddef.h>
+#include <string.h>
+
+#ifdef CONFIG_SHELL
+#include <zephyr/shell/shell.h>
+#endif
+
+#ifdef CONFIG_RETAINED_STATE
+
+// Bump the version when the meaning of a field changes without changing the size
+#define RETAINED_STATE_VERSION 1
+#define RETAINED_STATE_LAYOUT ((RETAINED_STATE_VERSION << 16) | sizeof(retained_state_t))
+
+static __noinit retained_state_t retained;
+static bool warm;
+// Serializes the modifications and the CRC update, a CRC computed alongside a write would reject the state
+static K_MUTEX_DEFINE(retained_lock);
+
+static uint32_t calculate_crc(void)
+{
+    return crc32_ieee((const uint8_t *)&retained, offsetof(retained_state_t, crc));
+}
+
+/**
+ * @brief Validate the retained state before anything uses it, clear it if it does not survive the reset
+ *
+ * @return int, always 0
+ */
+static int init_retained_state(void)
+{
+    warm = retained.layout == RETAINED_STATE_LAYOUT && retained.crc == calculate_crc();
+    if (warm)
+    {
+        retained.boot_count++;
+    }
+    else
+    {
+        memset(&retained, 0, sizeof(retained));
+        retained.layout = RETAINED_STATE_LAYOUT;
+    }
+    // Nothing else runs before the kernel starts
+    retained.crc = calculate_crc();
+    return 0;
+}
+
+SYS_INIT(init_retained_state, PRE_KERNEL_1, 0);
+
+retained_state_t *get_retained_state(void)
+{
+    return &retained;
+}
+
+bool retained_state_is_warm(void)
+{
+    return warm;
+}
+
+retained_state_t *lock_retained_state(void)
+{
+    k_mutex_lock(&retained_lock, K_FOREVER);
+    return &retained;
+}
+
+void unlock_retained_state(void)
+{
+    retained.crc = calculate_crc();
+    k_mutex_unlock(&retained_lock);
+}
+
+void record_boot_to_ready(int64_t ready_ms)
+{
+    retained_state_t *state = lock_retained_state();
+    if (warm)
+    {
+        state->warm_ready_ms = ready_ms;
+    }
+    else
+    {
+        state->cold_ready_ms = ready_ms;
+    }
+    unlock_retained_state();
+}
+
+#ifdef CONFIG_SHELL
+/**
+ * @brief Shell command printing the boot count and the boot to ready times
+ *
+ * @param sh Shell instance
+ * @param argc Number of arguments
+ * @param argv Arguments
+ * @return int, always 0
+ */
+static int cmd_boot(const struct shell *sh, size_t argc, char **argv)
+{
+    shell_print(sh, "%s boot, %u warm boots since the last cold boot.", warm ? "Warm" : "Cold", retained.boot_count);
+    shell_print(sh, "Boot to first measurement: cold %u ms, warm %u ms.", retained.cold_ready_ms,
+                retained.warm_ready_ms);
+    return 0;
+}
+
+SHELL_CMD_REGISTER(boot, NULL, "Print the boot count and the boot to ready times", cmd_boot);
+#endif // CONFIG_SHELL
+
+#endif // CONFIG_RETAINED_STATE
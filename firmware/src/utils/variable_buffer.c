@@ -1,11 +1,54 @@
 #include <utils/variable_buffer.h>
+#include <utils/retained_state.h>
 
 # include <zephyr/kernel.h>
 
 #include <stdlib.h>
+#include <string.h>
 
 static variable_buffer_t buffers[NUM_VARIABLES];
 
+#ifdef CONFIG_RETAINED_STATE
+// Written without locking, copied to the retained state once per measurement cycle by save_buffers
+static float buffer_data[NUM_VARIABLES][CONFIG_MEASUREMENTS_PER_INTERVAL];
+
+int init_buffers(size_t size)
+{
+	// After a warm boot the retained state still holds the values measured before the reset
+	retained_state_t *retained = get_retained_state();
+	if (size != CONFIG_MEASUREMENTS_PER_INTERVAL)
+	{
+		return -EINVAL;
+	}
+	memcpy(buffer_data, retained->buffers, sizeof(buffer_data));
+	for (int i = 0; i < NUM_VARIABLES; i++)
+	{
+		buffers[i].data = buffer_data[i];
+		buffers[i].size = size;
+		buffers[i].index = retained->buffer_index[i] % size;
+	}
+	return 0;
+}
+
+void save_buffers(float data[][CONFIG_MEASUREMENTS_PER_INTERVAL], uint16_t *indices)
+{
+	memcpy(data, buffer_data, sizeof(buffer_data));
+	for (int i = 0; i < NUM_VARIABLES; i++)
+	{
+		indices[i] = buffers[i].index;
+	}
+}
+
+void free_buffers(void)
+{
+	for (int i = 0; i < NUM_VARIABLES; i++)
+	{
+		buffers[i].data = NULL;
+		buffers[i].size = 0;
+		buffers[i].index = 0;
+	}
+}
+#else
 int init_buffers(size_t size)
 {
 	for (int i = 0; i < NUM_VARIABLES; i++)
@@ -36,6 +79,7 @@ void free_buffers(void)
 		buffers[i].index = 0;
 	}
 }
+#endif
 
 void set_value(variable_t variable, float value)
 {
@@ -0,0 +1,46 @@
+// Built with and without CONFIG_BMP390_FLOAT_COMPENSATION, see CMakeLists.txt
+#ifdef CONFIG_BMP390_FLOAT_COMPENSATION
+// Both builds are linked into the test, keep the public function of the driver apart
+#define bmp390_get_bus_stats bmp390_float_get_bus_stats
+#endif
+#include "../../src/drivers/bmp390.c"
+
+#include "compensation.h"
+
+static bmp390_data_t data;
+static const bmp390_config_t config = {
+    .bus = {.bus = &(struct device){.name = "i2c"}},
+    .mode = BMP390_MODE_NORMAL,
+    .enable_pressure = true,
+    .enable_temp = true,
+};
+static const struct device dev = {
+    .name = "bmp390",
+    .config = &config,
+    .api = &bmp390_api,
+    .data = &data,
+};
+
+static int init(void)
+{
+    memset(&data, 0, sizeof(data));
+    return bmp390_init(&dev);
+}
+
+static int sample(uint32_t t_raw, uint32_t p_raw, struct sensor_value *temp, struct sensor_value *press)
+{
+    set_raw_sample(t_raw, p_raw);
+    int rc = bmp390_sample_fetch(&dev, SENSOR_CHAN_ALL);
+    if (rc != 0)
+    {
+        return rc;
+    }
+    rc = bmp390_channel_get(&dev, SENSOR_CHAN_AMBIENT_TEMP, temp);
+    return rc != 0 ? rc : bmp390_channel_get(&dev, SENSOR_CHAN_PRESS, press);
+}
+
+#ifdef CONFIG_BMP390_FLOAT_COMPENSATION
+const bmp390_compensation_t bmp390_float_compensation = {"float", init, sample};
+#else
+const bmp390_compensation_t bmp390_int_compensation = {"int64", init, sample};
+#endif
@@ -0,0 +1,29 @@
+#ifndef BMP390_COMPENSATION_H
+#define BMP390_COMPENSATION_H
+
+#include <zephyr/drivers/sensor.h>
+
+/**
+ * @brief One build of the BMP390 driver
+ *
+ */
+typedef struct
+{
+    const char *name;
+    int (*init)(void); // Soft reset and calibration
+    // Fetch the raw sample and get both channels
+    int (*sample)(uint32_t t_raw, uint32_t p_raw, struct sensor_value *temp, struct sensor_value *press);
+} bmp390_compensation_t;
+
+extern const bmp390_compensation_t bmp390_float_compensation;
+extern const bmp390_compensation_t bmp390_int_compensation;
+
+/**
+ * @brief Set the raw sample returned by the emulated sensor on the next fetch, implemented by the test
+ *
+ * @param t_raw Raw temperature
+ * @param p_raw Raw pressure
+ */
+void set_raw_sample(uint32_t t_raw, uint32_t p_raw);
+
+#endif // BMP390_COMPENSATION_H
@@ -0,0 +1,237 @@
+// Compares the float compensation of the BMP390 driver with the Bosch int64 compensation over the full 24-bit raw
+// range and times both. Fails when a sample within the operating range differs by more than the tolerances below,
+// or when the float compensation leaves the valid pressure range anywhere.
+//
+// The operating range is selected with the compensation formulas of the datasheet in double precision. The int64
+// compensation wraps around outside of it and can land back within the range.
+#include "compensation.h"
+
+#include <drivers/bmp390.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define RAW_MAX 0xFFFFFF
+#define TEMP_RAW_STEP 0x1000
+#define PRESS_RAW_STEP 0x1000
+
+// Operating range of the BMP390
+#define TEMP_MIN_C -40.0
+#define TEMP_MAX_C 85.0
+#define PRESS_MIN_PA 30000.0
+#define PRESS_MAX_PA 125000.0
+
+// Documented in the help of CONFIG_BMP390_FLOAT_COMPENSATION
+#define TEMP_TOLERANCE_C 0.0001
+#define PRESS_TOLERANCE_PA 0.05
+
+#define TIMING_ROUNDS 20
+
+// Calibration read from a BMP390 on the sensor board
+static const bmp390_cal_data_t calibration = {
+    .t1 = 27794,
+    .t2 = 19053,
+    .t3 = -7,
+    .p1 = -1364,
+    .p2 = -2937,
+    .p3 = 35,
+    .p4 = 0,
+    .p5 = 25339,
+    .p6 = 30230,
+    .p7 = -10,
+    .p8 = -7,
+    .p9 = 15743,
+    .p10 = 15,
+    .p11 = -60,
+};
+
+static uint8_t raw_sample[BMP390_SAMPLE_BUFFER_SIZE];
+
+void set_raw_sample(uint32_t t_raw, uint32_t p_raw)
+{
+    raw_sample[0] = p_raw;
+    raw_sample[1] = p_raw >> 8;
+    raw_sample[2] = p_raw >> 16;
+    raw_sample[3] = t_raw;
+    raw_sample[4] = t_raw >> 8;
+    raw_sample[5] = t_raw >> 16;
+}
+
+int i2c_burst_read_dt(const struct i2c_dt_spec *spec, uint8_t start_addr, uint8_t *buf, uint32_t num_bytes)
+{
+    (void)spec;
+    memset(buf, 0, num_bytes);
+    switch (start_addr)
+    {
+    case BMP390_REG_CALIB0:
+        memcpy(buf, &calibration, MIN(num_bytes, sizeof(calibration)));
+        break;
+    case BMP390_REG_STATUS:
+        buf[0] = BMP390_STATUS_DRDY_PRESS | BMP390_STATUS_DRDY_TEMP;
+        break;
+    case BMP390_REG_DATA0:
+        memcpy(buf, raw_sample, MIN(num_bytes, sizeof(raw_sample)));
+        break;
+    default:
+        break;
+    }
+    return 0;
+}
+
+int i2c_reg_write_byte_dt(const struct i2c_dt_spec *spec, uint8_t reg_addr, uint8_t value)
+{
+    (void)spec;
+    (void)reg_addr;
+    (void)value;
+    return 0;
+}
+
+/**
+ * @brief Compensate a raw sample with the formulas of the BMP390 datasheet in double precision
+ *
+ * @param t_raw Raw temperature
+ * @param p_raw Raw pressure
+ * @param temp_c Compensated temperature in degC
+ * @param press_pa Compensated pressure in Pa
+ */
+static void compensate_exact(uint32_t t_raw, uint32_t p_raw, double *temp_c, double *press_pa)
+{
+    const bmp390_cal_data_t *cal = &calibration;
+    double t_diff = t_raw - ldexp(cal->t1, 8);
+    double t = t_diff * ldexp(cal->t2, -30) + t_diff * t_diff * ldexp(cal->t3, -48);
+    double p = p_raw;
+
+    double offset = ldexp(cal->p5, 3) + ldexp(cal->p6, -6) * t + ldexp(cal->p7, -8) * t * t +
+                    ldexp(cal->p8, -15) * t * t * t;
+    double sensitivity = ldexp(cal->p1 - 16384, -20) + ldexp(cal->p2 - 16384, -29) * t + ldexp(cal->p3, -32) * t * t +
+                         ldexp(cal->p4, -37) * t * t * t;
+    *temp_c = t;
+    *press_pa = offset + p * sensitivity + p * p * (ldexp(cal->p9, -48) + ldexp(cal->p10, -48) * t) +
+                p * p * p * ldexp(cal->p11, -65);
+}
+
+static double to_double(const struct sensor_value *val, double scale)
+{
+    return val->val1 + val->val2 / scale;
+}
+
+static double elapsed_ns(const struct timespec *start, const struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e9 + (end->tv_nsec - start->tv_nsec);
+}
+
+/**
+ * @brief Time the fetch and compensation of the samples within the operating range
+ *
+ * @param compensation Driver build to time
+ * @param samples Raw temperature and pressure pairs
+ * @param count Number of pairs
+ * @return double, nanoseconds per sample
+ */
+static double time_compensation(const bmp390_compensation_t *compensation, const uint32_t (*samples)[2], size_t count)
+{
+    struct sensor_value temp, press;
+    volatile int32_t sink = 0;
+    struct timespec start, end;
+
+    compensation->init();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int round = 0; round < TIMING_ROUNDS; round++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            compensation->sample(samples[i][0], samples[i][1], &temp, &press);
+            sink += temp.val2 + press.val2;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    (void)sink;
+    return elapsed_ns(&start, &end) / ((double)count * TIMING_ROUNDS);
+}
+
+int main(void)
+{
+    const bmp390_compensation_t *reference = &bmp390_int_compensation;
+    const bmp390_compensation_t *tested = &bmp390_float_compensation;
+    size_t capacity = (RAW_MAX / TEMP_RAW_STEP + 1) * (RAW_MAX / PRESS_RAW_STEP + 1);
+    uint32_t (*in_range)[2] = malloc(capacity * sizeof(*in_range));
+    size_t in_range_count = 0;
+    size_t total = 0;
+    size_t out_of_bounds = 0;
+    double max_temp_error = 0;
+    double max_press_error = 0;
+    double max_exact_error[2] = {0}; // Pressure error of the int64 and float compensation against double precision
+    // Pressure errors in steps of 0.01 Pa, the resolution of the channel value
+    size_t press_histogram[8] = {0};
+
+    if (in_range == NULL || reference->init() != 0 || tested->init() != 0)
+    {
+        printf("Failed to initialize the drivers\n");
+        return 1;
+    }
+
+    for (uint32_t t_raw = 0; t_raw <= RAW_MAX; t_raw += TEMP_RAW_STEP)
+    {
+        for (uint32_t p_raw = 0; p_raw <= RAW_MAX; p_raw += PRESS_RAW_STEP)
+        {
+            struct sensor_value ref_temp, ref_press, temp, press;
+            reference->sample(t_raw, p_raw, &ref_temp, &ref_press);
+            tested->sample(t_raw, p_raw, &temp, &press);
+            total++;
+
+            double press_pa = to_double(&press, 100.0);
+            if (press.val1 < 0 || press_pa > BMP390_PRESS_MAX_PA || press.val2 < 0 || press.val2 > 99)
+            {
+                out_of_bounds++;
+            }
+
+            double exact_temp_c, exact_press_pa;
+            compensate_exact(t_raw, p_raw, &exact_temp_c, &exact_press_pa);
+            if (exact_temp_c < TEMP_MIN_C || exact_temp_c > TEMP_MAX_C || exact_press_pa < PRESS_MIN_PA ||
+                exact_press_pa > PRESS_MAX_PA)
+            {
+                continue;
+            }
+            in_range[in_range_count][0] = t_raw;
+            in_range[in_range_count][1] = p_raw;
+            in_range_count++;
+
+            double ref_press_pa = to_double(&ref_press, 100.0);
+            double temp_error = fabs(to_double(&temp, 1000000.0) - to_double(&ref_temp, 1000000.0));
+            double press_error = fabs(press_pa - ref_press_pa);
+            max_exact_error[0] = MAX(max_exact_error[0], fabs(ref_press_pa - exact_press_pa));
+            max_exact_error[1] = MAX(max_exact_error[1], fabs(press_pa - exact_press_pa));
+            max_temp_error = MAX(max_temp_error, temp_error);
+            max_press_error = MAX(max_press_error, press_error);
+            press_histogram[MIN((size_t)(press_error * 100.0 + 0.5), ARRAY_SIZE(press_histogram) - 1)]++;
+        }
+    }
+
+    printf("%zu raw samples over the full range, %zu within -40..85 degC and 300..1250 hPa\n", total, in_range_count);
+    printf("Max error within the operating range: %.6f degC, %.3f Pa\n", max_temp_error, max_press_error);
+    printf("Max pressure error against double precision: %s %.3f Pa, %s %.3f Pa\n", reference->name,
+           max_exact_error[0], tested->name, max_exact_error[1]);
+    printf("Pressure error distribution:\n");
+    for (size_t i = 0; i < ARRAY_SIZE(press_histogram); i++)
+    {
+        printf("  %s%.2f Pa %10zu (%5.2f%%)\n", i + 1 == ARRAY_SIZE(press_histogram) ? ">=" : "  ", i / 100.0,
+               press_histogram[i], 100.0 * press_histogram[i] / in_range_count);
+    }
+    printf("Float pressure out of 0..%.0f Pa: %zu samples\n", BMP390_PRESS_MAX_PA, out_of_bounds);
+
+    double reference_ns = time_compensation(reference, in_range, in_range_count);
+    double tested_ns = time_compensation(tested, in_range, in_range_count);
+    printf("Fetch and compensation per sample: %s %.1f ns, %s %.1f ns (%.2fx)\n", reference->name, reference_ns,
+           tested->name, tested_ns, reference_ns / tested_ns);
+
+    free(in_range);
+    if (max_temp_error > TEMP_TOLERANCE_C || max_press_error > PRESS_TOLERANCE_PA || out_of_bounds > 0)
+    {
+        printf("FAIL: tolerance %.4f degC, %.2f Pa\n", TEMP_TOLERANCE_C, PRESS_TOLERANCE_PA);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
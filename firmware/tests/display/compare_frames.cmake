@@ -0,0 +1,13 @@
+# Runs the frame dumping display test and compares its frames with the reference images, called by ctest:
+#   cmake -DEXECUTABLE=... -DPYTHON=... -DSCRIPT=... -DGOLDEN_DIR=... -DOUTPUT_DIR=... -P compare_frames.cmake
+set(LOG ${OUTPUT_DIR}.log)
+execute_process(COMMAND ${EXECUTABLE} OUTPUT_FILE ${LOG} RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "${EXECUTABLE} failed (${rc}), see ${LOG}")
+endif()
+
+file(REMOVE_RECURSE ${OUTPUT_DIR})
+execute_process(COMMAND ${PYTHON} ${SCRIPT} ${LOG} ${OUTPUT_DIR} --compare ${GOLDEN_DIR} RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "Frames differ from ${GOLDEN_DIR}, the frames are in ${OUTPUT_DIR}")
+endif()
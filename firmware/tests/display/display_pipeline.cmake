@@ -0,0 +1,70 @@
+# Host build of the display pipeline with the direct renderer drawing into the recording display of native_sim:
+# e_paper_display.c with its deadbands, trends and display policy, configured like the XIAO expansion board. Shared
+# by the display tests and the battery estimate, the including directory gets the fonts in its binary directory.
+include(${FIRMWARE_DIR}/cmake/display_fonts.cmake)
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+set(FONT_OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/fonts/bitmap_fonts.h)
+add_custom_command(
+    OUTPUT ${FONT_OUTPUT}
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${CMAKE_CURRENT_BINARY_DIR}/fonts
+    COMMAND ${Python3_EXECUTABLE} scripts/font_converter.py ${FONT_SOURCE} ${FONT_OUTPUT} ${FONT_ARGS} --format direct
+            --rle
+    DEPENDS ${FONT_DEPENDS}
+    WORKING_DIRECTORY ${FIRMWARE_DIR}
+    COMMENT "Generating display fonts"
+)
+
+set(DISPLAY_SOURCES
+    ${CMAKE_CURRENT_LIST_DIR}/recording.c
+    ${FONT_OUTPUT}
+    ${FIRMWARE_DIR}/src/components/e_paper_display.c
+    ${FIRMWARE_DIR}/src/components/display_policy.c
+    ${FIRMWARE_DIR}/src/components/display_renderer_direct.c
+    ${FIRMWARE_DIR}/src/utils/bitmap_font.c
+    ${FIRMWARE_DIR}/src/utils/decimal_format.c
+    ${FIRMWARE_DIR}/src/utils/air_quality_mapper.c
+)
+
+# Add the display pipeline to a target
+function(add_display_pipeline target)
+    target_sources(${target} PRIVATE ${DISPLAY_SOURCES})
+    target_include_directories(${target} PRIVATE
+        ${TEST_STUBS_DIR}
+        ${FIRMWARE_DIR}/include
+        ${CMAKE_CURRENT_BINARY_DIR}/fonts
+    )
+    # Panel of the XIAO expansion board and the Kconfig defaults of the display options
+    target_compile_definitions(${target} PRIVATE
+        DT_N_ssd1680_P_width=250
+        DT_N_ssd1680_P_height=136
+        CONFIG_ENABLE_EPD
+        CONFIG_RECORDING_DISPLAY
+        CONFIG_DISPLAY_RENDERER_DIRECT
+        CONFIG_DISPLAY_FONT_RLE
+        CONFIG_DISPLAY_TEMPERATURE_DEADBAND=20
+        CONFIG_DISPLAY_HUMIDITY_DEADBAND=2
+        CONFIG_DISPLAY_CO2_DEADBAND=20
+        CONFIG_DISPLAY_VOC_INDEX_DEADBAND=10
+        CONFIG_DISPLAY_BATTERY_DEADBAND=2
+        CONFIG_DISPLAY_STALE_TIMEOUT_S=3600
+        CONFIG_DISPLAY_TREND
+        CONFIG_DISPLAY_TREND_COLUMN_S=1800
+        CONFIG_DISPLAY_TREND_TEMPERATURE_MIN=15
+        CONFIG_DISPLAY_TREND_TEMPERATURE_MAX=30
+        CONFIG_DISPLAY_TREND_CO2_MIN=400
+        CONFIG_DISPLAY_TREND_CO2_MAX=2000
+        CONFIG_EPD_DAMAGE_PER_UPDATE=4
+        CONFIG_EPD_DAMAGE_THRESHOLD=60
+        CONFIG_EPD_OPPORTUNISTIC_DAMAGE_THRESHOLD=20
+        CONFIG_EPD_QUIET_PERIOD_S=10800
+        CONFIG_DISPLAY_POLICY
+        CONFIG_DISPLAY_POLICY_LOW_BATTERY_LEVEL=20
+        CONFIG_DISPLAY_POLICY_STABLE_PERIOD_S=7200
+        CONFIG_DISPLAY_POLICY_ACTIVE_INTERVAL_S=0
+        CONFIG_DISPLAY_POLICY_STABLE_INTERVAL_S=3600
+        CONFIG_DISPLAY_POLICY_LOW_BATTERY_INTERVAL_S=3600
+        CONFIG_DISPLAY_POLICY_LOW_BATTERY_DAMAGE_THRESHOLD=120
+    )
+    target_link_libraries(${target} m)
+endfunction()
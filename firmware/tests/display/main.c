@@ -0,0 +1,140 @@
+// Runs the display pipeline with the direct renderer over a scripted day and a half: the pairing notification, slow
+// temperature and humidity cycles, an occupied room raising the CO2, a VOC event, a missing CO2 reading and finally a
+// low battery. The panel is the recording display of native_sim. Reports the refreshes and the render time per
+// refresh, and fails when the display reports an error or never refreshes.
+#include <components/e_paper_display.h>
+#include <components/event_handler.h>
+#include <components/power_manager.h>
+#include <drivers/recording_display.h>
+#include <utils/variable_buffer.h>
+
+#include <stdio.h>
+
+#define UPDATE_INTERVAL_S 300
+#define SCRIPT_HOURS 30
+#define LOW_BATTERY_HOUR 24
+
+static int64_t uptime_ms;
+static float latest[NUM_VARIABLES];
+static uint32_t warnings;
+
+int64_t k_uptime_get(void)
+{
+    return uptime_ms;
+}
+
+float get_latest(variable_t variable)
+{
+    return latest[variable];
+}
+
+int power_get(power_domain_t domain)
+{
+    (void)domain;
+    return 0;
+}
+
+int power_put(power_domain_t domain)
+{
+    (void)domain;
+    return 0;
+}
+
+void dispatch_event(event_t event)
+{
+    if (event == PERIODIC_TASK_WARNING || event == PERIODIC_TASK_ERROR)
+    {
+        warnings++;
+    }
+}
+
+/**
+ * @brief Triangle wave between 0 and 1, integer based so the frames do not depend on the libm of the host
+ *
+ * @param seconds Time into the script
+ * @param period_s Period of the wave
+ * @return float, level of the wave
+ */
+static float triangle(int64_t seconds, int64_t period_s)
+{
+    int64_t phase = seconds % period_s;
+    int64_t half = period_s / 2;
+    return (float)(phase < half ? phase : period_s - phase) / half;
+}
+
+/**
+ * @brief Set the values measured at a time of the script
+ *
+ * @param seconds Time into the script
+ */
+static void set_script_values(int64_t seconds)
+{
+    int64_t hour = seconds / 3600;
+    float temperature = 19.5f + 4.0f * triangle(seconds, 24 * 3600);
+    float humidity = 40.0f + 12.0f * triangle(seconds + 6 * 3600, 24 * 3600);
+
+    // Occupied from 9 to 12, the CO2 rises by 300 ppm per hour and decays afterwards
+    float co2 = 450.0f;
+    if (hour >= 9 && hour < 12)
+    {
+        co2 += (seconds - 9 * 3600) / 12;
+    }
+    else if (hour >= 12 && hour < 15)
+    {
+        co2 += 900.0f - (seconds - 12 * 3600) / 12;
+    }
+    // The SCD4x reading is missing for two updates
+    if (seconds >= 16 * 3600 && seconds < 16 * 3600 + 2 * UPDATE_INTERVAL_S)
+    {
+        co2 = -1;
+    }
+
+    // Cooking in the evening
+    float voc_index = hour >= 18 && hour < 19 ? 100.0f + (seconds - 18 * 3600) / 12 : 100.0f;
+
+    latest[TEMPERATURE] = temperature;
+    latest[HUMIDITY] = humidity;
+    latest[CO2_CONCENTRATION] = co2;
+    latest[VOC_INDEX] = voc_index;
+    latest[BATTERY_LEVEL] = hour >= LOW_BATTERY_HOUR ? 15.0f : 80.0f - seconds / (4 * 3600);
+}
+
+int main(void)
+{
+    if (init_e_paper_display() != 0)
+    {
+        printf("Failed to initialize the display\n");
+        return 1;
+    }
+
+    int rc = display_notification("Pairing");
+    uptime_ms += 30 * MSEC_PER_SEC;
+    rc |= display_notification("");
+    for (int64_t seconds = 0; seconds < SCRIPT_HOURS * 3600; seconds += UPDATE_INTERVAL_S)
+    {
+        uptime_ms = 60 * MSEC_PER_SEC + seconds * MSEC_PER_SEC;
+        set_script_values(seconds);
+        rc |= update_e_paper_display();
+    }
+
+    recording_display_stats_t stats;
+    recording_display_get_stats(test_device_get("ssd1680"), &stats);
+    uint32_t refreshes = get_display_refreshes();
+    printf("%u updates over %d h, %u refreshes, %u skipped by hysteresis, %u deferred\n",
+           SCRIPT_HOURS * 3600 / UPDATE_INTERVAL_S + 2, SCRIPT_HOURS, refreshes, get_skipped_refreshes(),
+           get_deferred_refreshes());
+    printf("Panel: %u full and %u partial refreshes, %u writes, %llu bytes\n", stats.full_refreshes,
+           stats.partial_refreshes, stats.writes, (unsigned long long)stats.bytes);
+    if (refreshes > 0)
+    {
+        printf("Render time per refresh: %.1f us\n", (double)get_display_render_time_us() / refreshes);
+    }
+
+    if (rc != 0 || warnings > 0 || refreshes == 0)
+    {
+        printf("FAIL: %u display warnings\n", warnings);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
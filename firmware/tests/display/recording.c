@@ -0,0 +1,34 @@
+// The recording display of native_sim as the EPD of the test
+#include "../../src/drivers/recording_display.c"
+
+#define PANEL_WIDTH DT_PROP(DT_ALIAS(ssd1680), width)
+#define PANEL_HEIGHT DT_PROP(DT_ALIAS(ssd1680), height)
+
+static uint8_t framebuffer[PANEL_WIDTH * PANEL_HEIGHT / 8];
+static recording_display_data_t display_data;
+static const recording_display_config_t display_config = {
+    .width = PANEL_WIDTH,
+    .height = PANEL_HEIGHT,
+    .framebuffer = framebuffer,
+};
+static const struct device display = {
+    .name = "recording_display",
+    .config = &display_config,
+    .api = &recording_display_api,
+    .data = &display_data,
+};
+
+const struct device *test_device_get(const char *node)
+{
+    static bool initialized;
+    if (strcmp(node, "ssd1680") != 0)
+    {
+        return NULL;
+    }
+    if (!initialized)
+    {
+        recording_display_init(&display);
+        initialized = true;
+    }
+    return &display;
+}
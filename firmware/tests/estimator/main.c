@@ -0,0 +1,160 @@
+// Replays the periodic task of air_quality_monitor.c over the simulated days of the native_sim estimator build and
+// prints its battery estimate. Each cycle measures for the duration of the SCD4X single shot, hands the values to the
+// display and advertises every CONFIG_MEASUREMENTS_PER_INTERVAL cycles until the central has read them. The SGP40
+// bursts run in parallel. The values follow a day with an occupied room and cooking in the evening, there is no
+// battery monitor as on native_sim. Fails when no charge is accounted or the display reports an error.
+#include <components/e_paper_display.h>
+#include <components/event_handler.h>
+#include <components/sensors.h>
+#include <components/state_manager.h>
+#include <drivers/scd4x.h>
+#include <estimator/battery_estimate.h>
+#include <utils/variable_buffer.h>
+
+#include <stdio.h>
+
+#define CYCLE_MS (CONFIG_ADVERTISEMENT_INTERVAL / CONFIG_MEASUREMENTS_PER_INTERVAL)
+#define FIRST_TASK_DELAY_MS 10000
+#define SGP40_BURST_MS (CONFIG_SGP40_CONDITIONING_SAMPLES * 1000)
+
+static int64_t uptime_ms;
+static int64_t next_burst_ms;
+static float latest[NUM_VARIABLES];
+static uint32_t warnings;
+
+int64_t k_uptime_get(void)
+{
+    return uptime_ms;
+}
+
+float get_latest(variable_t variable)
+{
+    return latest[variable];
+}
+
+void dispatch_event(event_t event)
+{
+    if (event == PERIODIC_TASK_WARNING || event == PERIODIC_TASK_ERROR)
+    {
+        warnings++;
+    }
+}
+
+// The sensors are powered by the state manager, their measurements are replayed by the script
+int activate_sensors(void)
+{
+    return 0;
+}
+
+int suspend_sensors(void)
+{
+    return 0;
+}
+
+int save_sensors_state(void)
+{
+    return 0;
+}
+
+int stop_voc_sampling(void)
+{
+    return 0;
+}
+
+/**
+ * @brief Let time pass, the SGP40 bursts due meanwhile are accounted as they run alongside any state
+ *
+ * @param duration_ms Time to pass
+ */
+static void advance(int64_t duration_ms)
+{
+    uptime_ms += duration_ms;
+    while (next_burst_ms + SGP40_BURST_MS <= uptime_ms)
+    {
+        record_parallel_state(SAMPLING, SGP40_BURST_MS);
+        next_burst_ms += CONFIG_SGP40_LOW_POWER_INTERVAL_S * MSEC_PER_SEC;
+    }
+}
+
+/**
+ * @brief Triangle wave between 0 and 1
+ *
+ * @param seconds Time into the script
+ * @param period_s Period of the wave
+ * @return float, level of the wave
+ */
+static float triangle(int64_t seconds, int64_t period_s)
+{
+    int64_t phase = seconds % period_s;
+    int64_t half = period_s / 2;
+    return (float)(phase < half ? phase : period_s - phase) / half;
+}
+
+/**
+ * @brief Set the values measured at a time of the day
+ *
+ * @param seconds Time since boot
+ */
+static void set_script_values(int64_t seconds)
+{
+    int64_t day_s = seconds % (24 * 3600);
+    int64_t hour = day_s / 3600;
+
+    // Occupied from 9 to 12, the CO2 rises by 300 ppm per hour and decays afterwards
+    float co2 = 450.0f;
+    if (hour >= 9 && hour < 12)
+    {
+        co2 += (day_s - 9 * 3600) / 12;
+    }
+    else if (hour >= 12 && hour < 15)
+    {
+        co2 += 900.0f - (day_s - 12 * 3600) / 12;
+    }
+
+    latest[TEMPERATURE] = 19.5f + 4.0f * triangle(seconds, 24 * 3600);
+    latest[HUMIDITY] = 40.0f + 12.0f * triangle(seconds + 6 * 3600, 24 * 3600);
+    latest[CO2_CONCENTRATION] = co2;
+    latest[VOC_INDEX] = hour >= 18 && hour < 19 ? 100.0f + (day_s - 18 * 3600) / 12 : 100.0f;
+    latest[BATTERY_LEVEL] = -1.0f;
+}
+
+int main(void)
+{
+    // Boot and pairing window, the central pairs after the connect delay
+    set_state(INITIALIZING);
+    int rc = init_e_paper_display();
+    set_state(STARTUP);
+    rc |= display_notification("Pairing");
+    advance(CONFIG_ESTIMATOR_CENTRAL_CONNECT_DELAY);
+    rc |= display_notification("");
+    set_state(IDLE);
+    advance(FIRST_TASK_DELAY_MS);
+
+    uint32_t measurement = 0;
+    while (uptime_ms < (int64_t)CONFIG_ESTIMATOR_SIMULATED_DAYS * 24 * 3600 * MSEC_PER_SEC)
+    {
+        int64_t start_ms = uptime_ms;
+
+        set_state(MEASURING);
+        advance(SCD4X_SINGLE_SHOT_TIME_MS);
+        set_script_values(uptime_ms / MSEC_PER_SEC);
+        rc |= update_e_paper_display();
+
+        if (++measurement % CONFIG_MEASUREMENTS_PER_INTERVAL == 0)
+        {
+            set_state(ADVERTISING);
+            advance(CONFIG_ESTIMATOR_CENTRAL_CONNECT_DELAY + CONFIG_ESTIMATOR_CENTRAL_READ_TIME);
+        }
+        set_state(IDLE);
+        advance(start_ms + CYCLE_MS - uptime_ms);
+    }
+
+    rc |= print_battery_estimate();
+    if (rc != 0 || warnings > 0)
+    {
+        printf("FAIL: %u display warnings\n", warnings);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,207 @@
+// Compares the VOC indices of the fixed-point gas index algorithm with the Sensirion float implementation and reports
+// the cycles per sample of both, and of the fixed-point batch entry point against single calls. The traces are synthetic weeks of SGP40 ticks at the 1 s and 10 s sampling intervals: a
+// baseline with daily drift, sensor noise, a few VOC events per day and occasional invalid samples. Fails when an index
+// differs by more than the tolerance below, also after restoring float states into the fixed-point build, or when the
+// batches do not give the same indices and states as single calls.
+#include "sensirion_gas_index_algorithm.h"
+
+#include <utils/gas_index_fixed.h>
+#include <zephyr/sys/util.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#define TRACE_DAYS 7
+#define TRACE_SEEDS 8
+
+// Documented in the help of CONFIG_GAS_INDEX_FIXED_POINT
+#define MAX_INDEX_ERROR 1
+// Samples per batch, e.g. an SGP40 burst
+#define BATCH_SIZE 10
+
+static const int32_t sampling_intervals_s[] = {1, 10};
+
+static uint32_t rng_state;
+
+static double uniform(void)
+{
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return (rng_state >> 8) / 16777216.0;
+}
+
+static double normal(void)
+{
+    double u1 = uniform() + 1e-12;
+    double u2 = uniform();
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+/**
+ * @brief Generate a trace of raw SGP40 ticks, a VOC event lowers the ticks
+ *
+ * @param count Number of samples
+ * @param interval_s Sampling interval in seconds
+ * @param seed Random seed
+ * @return int32_t*, allocated trace
+ */
+static int32_t *make_trace(size_t count, int32_t interval_s, uint32_t seed)
+{
+    int32_t *trace = malloc(count * sizeof(*trace));
+    double event = 0;
+    int32_t event_samples = 0;
+
+    rng_state = seed;
+    double baseline = 28000 + 6000 * uniform();
+    for (size_t i = 0; trace != NULL && i < count; i++)
+    {
+        double hours = (double)i * interval_s / 3600.0;
+        double drift = 800 * sin(2 * M_PI * hours / 24.0) + 300 * sin(2 * M_PI * hours / 5.3);
+        // About 6 events per day lasting 5 to 65 minutes, cooking or a window opened
+        if (event_samples <= 0 && uniform() < interval_s / 3600.0 * 0.25)
+        {
+            event_samples = (int32_t)((300 + uniform() * 3600) / interval_s);
+            event = 200 + uniform() * 2800;
+        }
+        double ticks = baseline + drift + 15 * normal() - (event_samples-- > 0 ? event : 0);
+        trace[i] = uniform() < 1e-4 ? 0 : (int32_t)ticks;
+    }
+    return trace;
+}
+
+/**
+ * @brief Read the cycle counter of the host, the nanoseconds of the monotonic clock when there is none
+ *
+ * @return uint64_t, current count
+ */
+static uint64_t read_cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + now.tv_nsec;
+#endif
+}
+
+int main(void)
+{
+    // Index differences between the fixed-point and float implementation
+    size_t histogram[MAX_INDEX_ERROR + 2] = {0};
+    size_t total = 0;
+    int32_t max_error = 0;
+    int32_t max_restored_error = 0;
+    uint64_t float_cycles = 0;
+    uint64_t fixed_cycles = 0;
+    uint64_t batch_cycles = 0;
+    size_t batch_mismatches = 0;
+
+    for (size_t n = 0; n < ARRAY_SIZE(sampling_intervals_s); n++)
+    {
+        int32_t interval_s = sampling_intervals_s[n];
+        size_t count = TRACE_DAYS * 24 * 3600 / interval_s;
+        for (uint32_t seed = 1; seed <= TRACE_SEEDS; seed++)
+        {
+            int32_t *trace = make_trace(count, interval_s, seed * 7919);
+            int32_t *float_index = malloc(count * sizeof(*float_index));
+            int32_t *fixed_index = malloc(count * sizeof(*fixed_index));
+            int32_t *batch_index = malloc(count * sizeof(*batch_index));
+            if (trace == NULL || float_index == NULL || fixed_index == NULL || batch_index == NULL)
+            {
+                printf("Out of memory\n");
+                return 1;
+            }
+
+            GasIndexAlgorithmParams float_params;
+            gas_index_fixed_params_t fixed_params;
+            gas_index_fixed_params_t batch_params;
+            uint64_t start, middle, end;
+            GasIndexAlgorithm_init_with_sampling_interval(&float_params, GasIndexAlgorithm_ALGORITHM_TYPE_VOC,
+                                                          interval_s);
+            gas_index_fixed_init(&fixed_params, interval_s);
+            start = read_cycles();
+            for (size_t i = 0; i < count; i++)
+            {
+                GasIndexAlgorithm_process(&float_params, trace[i], &float_index[i]);
+            }
+            middle = read_cycles();
+            for (size_t i = 0; i < count; i++)
+            {
+                gas_index_fixed_process(&fixed_params, trace[i], &fixed_index[i]);
+            }
+            end = read_cycles();
+            float_cycles += middle - start;
+            fixed_cycles += end - middle;
+
+            gas_index_fixed_init(&batch_params, interval_s);
+            start = read_cycles();
+            for (size_t i = 0; i < count; i += BATCH_SIZE)
+            {
+                gas_index_fixed_process_batch(&batch_params, &trace[i], &batch_index[i], MIN(BATCH_SIZE, count - i));
+            }
+            batch_cycles += read_cycles() - start;
+
+            float fixed_state0, fixed_state1, batch_state0, batch_state1;
+            gas_index_fixed_get_states(&fixed_params, &fixed_state0, &fixed_state1);
+            gas_index_fixed_get_states(&batch_params, &batch_state0, &batch_state1);
+            batch_mismatches += fixed_state0 != batch_state0 || fixed_state1 != batch_state1;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                int32_t error = abs(float_index[i] - fixed_index[i]);
+                max_error = MAX(max_error, error);
+                histogram[MIN(error, MAX_INDEX_ERROR + 1)]++;
+                batch_mismatches += batch_index[i] != fixed_index[i];
+            }
+            total += count;
+
+            // The checkpoints are saved by the float build, restore them into both and run the trace again
+            float state0, state1;
+            GasIndexAlgorithm_get_states(&float_params, &state0, &state1);
+            GasIndexAlgorithm_init_with_sampling_interval(&float_params, GasIndexAlgorithm_ALGORITHM_TYPE_VOC,
+                                                          interval_s);
+            gas_index_fixed_init(&fixed_params, interval_s);
+            GasIndexAlgorithm_set_states(&float_params, state0, state1);
+            gas_index_fixed_set_states(&fixed_params, state0, state1);
+            for (size_t i = 0; i < count; i++)
+            {
+                int32_t float_value, fixed_value;
+                GasIndexAlgorithm_process(&float_params, trace[i], &float_value);
+                gas_index_fixed_process(&fixed_params, trace[i], &fixed_value);
+                max_restored_error = MAX(max_restored_error, abs(float_value - fixed_value));
+            }
+
+            free(trace);
+            free(float_index);
+            free(fixed_index);
+            free(batch_index);
+        }
+    }
+
+    printf("%zu samples, %d days at 1 s and 10 s, %d traces each\n", total, TRACE_DAYS, TRACE_SEEDS);
+    printf("Max index error: %d, %d after restoring float states\n", max_error, max_restored_error);
+    printf("Index error distribution:\n");
+    for (size_t i = 0; i < ARRAY_SIZE(histogram); i++)
+    {
+        printf("  %s%zu %10zu (%7.4f%%)\n", i + 1 == ARRAY_SIZE(histogram) ? ">=" : "  ", i, histogram[i],
+               100.0 * histogram[i] / total);
+    }
+    printf("Host cycles per sample: float %.1f, fixed %.1f (%.2fx)\n", (double)float_cycles / total,
+           (double)fixed_cycles / total, (double)float_cycles / fixed_cycles);
+    printf("Fixed batches of %d: %.1f cycles per sample (%.2fx single calls), %zu mismatches\n", BATCH_SIZE,
+           (double)batch_cycles / total, (double)fixed_cycles / batch_cycles, batch_mismatches);
+
+    if (max_error > MAX_INDEX_ERROR || max_restored_error > MAX_INDEX_ERROR || batch_mismatches > 0)
+    {
+        printf("FAIL: tolerance %d, %zu batch mismatches\n", MAX_INDEX_ERROR, batch_mismatches);
+        return 1;
+    }
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,40 @@
+#ifndef STUBS_ZEPHYR_DEVICE_H
+#define STUBS_ZEPHYR_DEVICE_H
+
+#include <zephyr/kernel.h>
+
+struct device
+{
+    const char *name;
+    const void *config;
+    const void *api;
+    void *data;
+};
+
+static inline bool device_is_ready(const struct device *dev)
+{
+    return dev != NULL;
+}
+
+// Tests define their devices themselves, there is no devicetree on the host
+#define DT_INST_FOREACH_STATUS_OKAY(fn)
+
+// Nodes are looked up by name, e.g. DEVICE_DT_GET(DT_ALIAS(ssd1680)) returns test_device_get("ssd1680")
+#define DT_ALIAS(alias) alias
+#define DT_CHOSEN(chosen) chosen
+#define DEVICE_STRINGIFY(node) #node
+#define DEVICE_DT_GET(node) test_device_get(DEVICE_STRINGIFY(node))
+
+// Node properties are defined by the test, e.g. DT_PROP(DT_ALIAS(ssd1680), width) is DT_N_ssd1680_P_width
+#define DT_PROP_NAME(node, prop) DT_N_##node##_P_##prop
+#define DT_PROP(node, prop) DT_PROP_NAME(node, prop)
+
+/**
+ * @brief Get a device of the test by its node name, implemented by the tests using DEVICE_DT_GET
+ *
+ * @param node Alias or chosen node
+ * @return const struct device*, device or NULL if the test has none
+ */
+const struct device *test_device_get(const char *node);
+
+#endif // STUBS_ZEPHYR_DEVICE_H
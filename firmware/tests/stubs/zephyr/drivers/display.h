@@ -0,0 +1,81 @@
+#ifndef STUBS_ZEPHYR_DRIVERS_DISPLAY_H
+#define STUBS_ZEPHYR_DRIVERS_DISPLAY_H
+
+#include <zephyr/device.h>
+
+enum display_pixel_format
+{
+    PIXEL_FORMAT_RGB_888 = BIT(0),
+    PIXEL_FORMAT_MONO01 = BIT(1),
+    PIXEL_FORMAT_MONO10 = BIT(2),
+};
+
+#define SCREEN_INFO_MONO_VTILED BIT(0)
+#define SCREEN_INFO_MONO_MSB_FIRST BIT(1)
+#define SCREEN_INFO_EPD BIT(2)
+
+enum display_orientation
+{
+    DISPLAY_ORIENTATION_NORMAL,
+};
+
+struct display_capabilities
+{
+    uint16_t x_resolution;
+    uint16_t y_resolution;
+    uint32_t supported_pixel_formats;
+    uint32_t screen_info;
+    enum display_pixel_format current_pixel_format;
+    enum display_orientation current_orientation;
+};
+
+struct display_buffer_descriptor
+{
+    uint32_t buf_size;
+    uint16_t width;
+    uint16_t height;
+    uint16_t pitch;
+};
+
+struct display_driver_api
+{
+    int (*blanking_on)(const struct device *dev);
+    int (*blanking_off)(const struct device *dev);
+    int (*write)(const struct device *dev, const uint16_t x, const uint16_t y,
+                 const struct display_buffer_descriptor *desc, const void *buf);
+    void (*get_capabilities)(const struct device *dev, struct display_capabilities *caps);
+    int (*set_pixel_format)(const struct device *dev, const enum display_pixel_format pixel_format);
+};
+
+static inline int display_write(const struct device *dev, const uint16_t x, const uint16_t y,
+                                const struct display_buffer_descriptor *desc, const void *buf)
+{
+    const struct display_driver_api *api = dev->api;
+    return api->write(dev, x, y, desc, buf);
+}
+
+static inline int display_blanking_on(const struct device *dev)
+{
+    const struct display_driver_api *api = dev->api;
+    return api->blanking_on(dev);
+}
+
+static inline int display_blanking_off(const struct device *dev)
+{
+    const struct display_driver_api *api = dev->api;
+    return api->blanking_off(dev);
+}
+
+static inline void display_get_capabilities(const struct device *dev, struct display_capabilities *caps)
+{
+    const struct display_driver_api *api = dev->api;
+    api->get_capabilities(dev, caps);
+}
+
+static inline int display_set_pixel_format(const struct device *dev, const enum display_pixel_format pixel_format)
+{
+    const struct display_driver_api *api = dev->api;
+    return api->set_pixel_format(dev, pixel_format);
+}
+
+#endif // STUBS_ZEPHYR_DRIVERS_DISPLAY_H
@@ -0,0 +1,16 @@
+#ifndef STUBS_ZEPHYR_DRIVERS_I2C_H
+#define STUBS_ZEPHYR_DRIVERS_I2C_H
+
+#include <zephyr/device.h>
+
+struct i2c_dt_spec
+{
+    const struct device *bus;
+    uint16_t addr;
+};
+
+// Implemented by the tests, answering like the emulated sensor
+int i2c_burst_read_dt(const struct i2c_dt_spec *spec, uint8_t start_addr, uint8_t *buf, uint32_t num_bytes);
+int i2c_reg_write_byte_dt(const struct i2c_dt_spec *spec, uint8_t reg_addr, uint8_t value);
+
+#endif // STUBS_ZEPHYR_DRIVERS_I2C_H
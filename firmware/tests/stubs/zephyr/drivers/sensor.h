@@ -0,0 +1,42 @@
+#ifndef STUBS_ZEPHYR_DRIVERS_SENSOR_H
+#define STUBS_ZEPHYR_DRIVERS_SENSOR_H
+
+#include <zephyr/device.h>
+
+struct sensor_value
+{
+    int32_t val1;
+    int32_t val2;
+};
+
+enum sensor_channel
+{
+    SENSOR_CHAN_AMBIENT_TEMP = 13,
+    SENSOR_CHAN_PRESS = 15,
+    SENSOR_CHAN_ALL = 58,
+};
+
+enum sensor_attribute
+{
+    SENSOR_ATTR_PRIV_START = 0x8000,
+};
+
+struct sensor_driver_api
+{
+    int (*sample_fetch)(const struct device *dev, enum sensor_channel chan);
+    int (*channel_get)(const struct device *dev, enum sensor_channel chan, struct sensor_value *val);
+};
+
+static inline int sensor_value_from_float(struct sensor_value *val, float inp)
+{
+    // Same conversion as Zephyr
+    if (inp < (float)INT32_MIN || inp >= (float)INT32_MAX)
+    {
+        return -ERANGE;
+    }
+    val->val1 = (int32_t)inp;
+    val->val2 = (int32_t)((inp - (float)val->val1) * 1000000.0f);
+    return 0;
+}
+
+#endif // STUBS_ZEPHYR_DRIVERS_SENSOR_H
@@ -0,0 +1,139 @@
+#ifndef STUBS_ZEPHYR_KERNEL_H
+#define STUBS_ZEPHYR_KERNEL_H
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <zephyr/sys/util.h>
+
+#define __packed __attribute__((__packed__))
+
+typedef struct
+{
+    int64_t us;
+} k_timeout_t;
+
+#define K_USEC(t) ((k_timeout_t){(t)})
+#define K_MSEC(t) ((k_timeout_t){(t) * 1000LL})
+#define K_NO_WAIT ((k_timeout_t){0})
+#define K_FOREVER ((k_timeout_t){-1})
+#define K_PRIO_PREEMPT(x) (x)
+#define MSEC_PER_SEC 1000
+
+// Conversions are not waited for on the host
+static inline int32_t k_sleep(k_timeout_t timeout)
+{
+    (void)timeout;
+    return 0;
+}
+
+static inline void k_busy_wait(uint32_t usec_to_wait)
+{
+    (void)usec_to_wait;
+}
+
+/**
+ * @brief Uptime of the simulated clock, implemented by the tests using it
+ *
+ * @return int64_t, uptime in milliseconds
+ */
+int64_t k_uptime_get(void);
+
+// Cycles are host nanoseconds, for timing the code under test
+static inline uint32_t k_cycle_get_32(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000000LL + now.tv_nsec);
+}
+
+static inline uint32_t k_cyc_to_us_floor32(uint32_t cycles)
+{
+    return cycles / 1000;
+}
+
+// A single thread runs the tests, locks are not needed
+struct k_mutex
+{
+    int unused;
+};
+
+#define K_MUTEX_DEFINE(name) struct k_mutex name
+
+static inline int k_mutex_lock(struct k_mutex *mutex, k_timeout_t timeout)
+{
+    (void)mutex;
+    (void)timeout;
+    return 0;
+}
+
+static inline int k_mutex_unlock(struct k_mutex *mutex)
+{
+    (void)mutex;
+    return 0;
+}
+
+struct k_spinlock
+{
+    int unused;
+};
+
+typedef int k_spinlock_key_t;
+
+static inline k_spinlock_key_t k_spin_lock(struct k_spinlock *lock)
+{
+    (void)lock;
+    return 0;
+}
+
+static inline void k_spin_unlock(struct k_spinlock *lock, k_spinlock_key_t key)
+{
+    (void)lock;
+    (void)key;
+}
+
+// Work items run at once in the submitting thread, in submission order
+struct k_work;
+typedef void (*k_work_handler_t)(struct k_work *work);
+
+struct k_work
+{
+    k_work_handler_t handler;
+};
+
+struct k_work_q
+{
+    int unused;
+};
+
+typedef char k_thread_stack_t;
+
+#define K_THREAD_STACK_DEFINE(sym, size) k_thread_stack_t sym[1]
+
+static inline void k_work_queue_start(struct k_work_q *queue, k_thread_stack_t *stack, size_t stack_size, int prio,
+                                      const void *cfg)
+{
+    (void)queue;
+    (void)stack;
+    (void)stack_size;
+    (void)prio;
+    (void)cfg;
+}
+
+static inline void k_work_init(struct k_work *work, k_work_handler_t handler)
+{
+    work->handler = handler;
+}
+
+static inline int k_work_submit_to_queue(struct k_work_q *queue, struct k_work *work)
+{
+    (void)queue;
+    work->handler(work);
+    return 1;
+}
+
+#endif // STUBS_ZEPHYR_KERNEL_H
@@ -0,0 +1,11 @@
+#ifndef STUBS_ZEPHYR_LOGGING_LOG_H
+#define STUBS_ZEPHYR_LOGGING_LOG_H
+
+#define LOG_MODULE_REGISTER(...)
+#define LOG_MODULE_DECLARE(...)
+#define LOG_ERR(...) ((void)0)
+#define LOG_WRN(...) ((void)0)
+#define LOG_INF(...) ((void)0)
+#define LOG_DBG(...) ((void)0)
+
+#endif // STUBS_ZEPHYR_LOGGING_LOG_H
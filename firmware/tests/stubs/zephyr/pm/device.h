@@ -0,0 +1,12 @@
+#ifndef STUBS_ZEPHYR_PM_DEVICE_H
+#define STUBS_ZEPHYR_PM_DEVICE_H
+
+#include <zephyr/device.h>
+
+enum pm_device_action
+{
+    PM_DEVICE_ACTION_SUSPEND,
+    PM_DEVICE_ACTION_RESUME,
+};
+
+#endif // STUBS_ZEPHYR_PM_DEVICE_H
@@ -0,0 +1,25 @@
+#ifndef STUBS_ZEPHYR_PM_DEVICE_RUNTIME_H
+#define STUBS_ZEPHYR_PM_DEVICE_RUNTIME_H
+
+#include <zephyr/device.h>
+
+// Devices on the host have no power management
+static inline int pm_device_runtime_enable(const struct device *dev)
+{
+    (void)dev;
+    return -ENOTSUP;
+}
+
+static inline int pm_device_runtime_get(const struct device *dev)
+{
+    (void)dev;
+    return 0;
+}
+
+static inline int pm_device_runtime_put(const struct device *dev)
+{
+    (void)dev;
+    return 0;
+}
+
+#endif // STUBS_ZEPHYR_PM_DEVICE_RUNTIME_H
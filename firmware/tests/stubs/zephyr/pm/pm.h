@@ -0,0 +1,4 @@
+#ifndef STUBS_ZEPHYR_PM_PM_H
+#define STUBS_ZEPHYR_PM_PM_H
+
+#endif // STUBS_ZEPHYR_PM_PM_H
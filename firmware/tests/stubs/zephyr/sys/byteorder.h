@@ -0,0 +1,14 @@
+#ifndef STUBS_ZEPHYR_SYS_BYTEORDER_H
+#define STUBS_ZEPHYR_SYS_BYTEORDER_H
+
+#include <stdint.h>
+
+// The host is little endian like the nRF52840
+#define sys_le16_to_cpu(val) (val)
+
+static inline uint32_t sys_get_le24(const uint8_t src[3])
+{
+    return ((uint32_t)src[2] << 16) | ((uint32_t)src[1] << 8) | src[0];
+}
+
+#endif // STUBS_ZEPHYR_SYS_BYTEORDER_H
@@ -0,0 +1,8 @@
+#ifndef STUBS_ZEPHYR_SYS_PRINTK_H
+#define STUBS_ZEPHYR_SYS_PRINTK_H
+
+#include <stdio.h>
+
+#define printk printf
+
+#endif // STUBS_ZEPHYR_SYS_PRINTK_H
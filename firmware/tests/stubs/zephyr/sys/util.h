@@ -0,0 +1,18 @@
+#ifndef STUBS_ZEPHYR_SYS_UTIL_H
+#define STUBS_ZEPHYR_SYS_UTIL_H
+
+#define BIT(n) (1UL << (n))
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+#define CLAMP(val, low, high) (((val) <= (low)) ? (low) : MIN(val, high))
+#define BUILD_ASSERT(cond, msg) _Static_assert(cond, msg)
+
+// Same expansion as Zephyr, 1 when the option is defined to 1 and 0 otherwise
+#define Z_IS_ENABLED_PLACEHOLDER_1 0,
+#define Z_IS_ENABLED3(ignore_this, val, ...) val
+#define Z_IS_ENABLED2(one_or_two_args) Z_IS_ENABLED3(one_or_two_args 1, 0)
+#define Z_IS_ENABLED1(config_macro) Z_IS_ENABLED2(Z_IS_ENABLED_PLACEHOLDER_##config_macro)
+#define IS_ENABLED(config_macro) Z_IS_ENABLED1(config_macro)
+
+#endif // STUBS_ZEPHYR_SYS_UTIL_H